@@ -0,0 +1,99 @@
+/*
+ *		@brief: Benchmark for the prefetching pre-order traversal kernels of std::tree.
+ *
+ *		This file is part of CXX (https://github.com/seanhobeck/cxx).
+ *		Copyright (c) 2024 Sean Hobeck.
+ *
+ *		This program is free software: you can redistribute it and/or modify
+ *		it under the terms of the GNU General Public License as published by
+ *		the Free Software Foundation, either version 3 of the License, or
+ *		(at your option) any later version.
+ *
+ *		This program is distributed in the hope that it will be useful, but
+ *		WITHOUT ANY WARRANTY; without even the implied warranty of
+ *		MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ *		General Public License for more details.
+ *
+ *		You should have received a copy of the GNU General Public License
+ *		along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ *		@build:  g++ -std=c++20 -O2 -march=native bench/traverse.cpp -o traverse
+ *		@usage:  ./traverse [nodes = 4194304] [fanout = 4]
+ *
+ */
+
+/// @uses: std::chrono::steady_clock
+#include <chrono>
+
+/// @uses: std::printf
+#include <cstdio>
+
+/// @uses: std::strtoull
+#include <cstdlib>
+
+/// @uses: std::mt19937_64, std::shuffle
+#include <random>
+#include <algorithm>
+
+#include "../tree.h"
+
+using node_t = std::tree<std::uint64_t>::node;
+
+/// @fn: builds a tree bottom-up, level by level, shuffling every level before it is attached to its
+///	parents. every children array is therefore allocated in an order unrelated to the dfs order, which
+///	makes a pre-order walk jump around the heap (the miss-bound case the kernels target).
+static std::tree<std::uint64_t> build(std::size_t _n, std::size_t _fanout, std::mt19937_64 &_rng) {
+	/// level sizes from the root down until we have placed _n nodes.
+	std::vector<std::size_t> levels { 1 };
+	for (std::size_t total = 1; total < _n;) {
+		std::size_t next = std::min(levels.back() * _fanout, _n - total);
+		levels.push_back(next);
+		total += next;
+	}
+
+	std::uint64_t value = 0;
+	std::vector<node_t> below;
+	for (std::size_t l = levels.size(); l-- > 0;) {
+		std::vector<node_t> level;
+		level.reserve(levels[l]);
+		std::shuffle(below.begin(), below.end(), _rng);
+		std::size_t taken = 0;
+		for (std::size_t i = 0; i < levels[l]; ++i) {
+			node_t parent(value++);
+			std::size_t share = below.size() / levels[l] + (i < below.size() % levels[l]);
+			for (std::size_t k = 0; k < share; ++k)
+				parent.append(std::move(below[taken++]));
+			level.push_back(std::move(parent));
+		}
+		below = std::move(level);
+	}
+	return std::tree<std::uint64_t>(std::move(below.front()));
+}
+
+/// @fn: times one full traversal at the given prefetch distance, returning ns per node.
+static double run(std::tree<std::uint64_t> const &_tree, std::size_t _n, std::size_t _dist, std::uint64_t &_sink) {
+	auto start = std::chrono::steady_clock::now();
+	_tree.traverse([&](std::uint64_t const &v) { _sink += v; }, _dist);
+	auto elapsed = std::chrono::steady_clock::now() - start;
+	return (double) std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count() / (double) _n;
+}
+
+int main(int argc, char **argv) {
+	std::size_t n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : (1ull << 22);
+	std::size_t fanout = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 4;
+	std::mt19937_64 rng(0x5eed);
+
+	auto tree = build(n, fanout, rng);
+	std::uint64_t sink = 0;
+	std::printf("nodes: %zu, fanout: %zu, node size: %zu bytes\n", n, fanout, sizeof(node_t));
+
+	/// warm up once so that page faults do not land on the first measured run.
+	run(tree, n, 0, sink);
+	double base = run(tree, n, 0, sink);
+	std::printf("%-12s %8.2f ns/node\n", "distance 0", base);
+	for (std::size_t dist : { 2, 4, 8, 16, 32 }) {
+		double t = run(tree, n, dist, sink);
+		std::printf("distance %-3zu %8.2f ns/node (%.2fx)\n", dist, t, base / t);
+	}
+	return sink == 0;
+}
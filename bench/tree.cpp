@@ -0,0 +1,192 @@
+/*
+ *		@brief: Benchmark suite for the std::tree operations (append, search, isort, iteration, copying).
+ *
+ *		This file is part of CXX (https://github.com/seanhobeck/cxx).
+ *		Copyright (c) 2024 Sean Hobeck.
+ *
+ *		This program is free software: you can redistribute it and/or modify
+ *		it under the terms of the GNU General Public License as published by
+ *		the Free Software Foundation, either version 3 of the License, or
+ *		(at your option) any later version.
+ *
+ *		This program is distributed in the hope that it will be useful, but
+ *		WITHOUT ANY WARRANTY; without even the implied warranty of
+ *		MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ *		General Public License for more details.
+ *
+ *		You should have received a copy of the GNU General Public License
+ *		along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ *		@build:  g++ -std=c++20 -O2 -march=native bench/tree.cpp -o tree_bench
+ *		@usage:  ./tree_bench [max nodes = 10000000] [shape filter]
+ *
+ *		sizes go from 10^3 up to max nodes in powers of ten, for every shape (the isort and copy rows
+ *		keep a second tree alive, 10^7 nodes need a few GiB of memory).
+ *
+ */
+
+/// @uses: std::chrono::steady_clock
+#include <chrono>
+
+/// @uses: std::printf
+#include <cstdio>
+
+/// @uses: std::strtoull, std::malloc, std::free
+#include <cstdlib>
+
+/// @uses: std::strcmp
+#include <cstring>
+
+/// @uses: std::mt19937_64
+#include <random>
+
+/// @uses: std::bad_alloc
+#include <new>
+
+/// @uses: getrusage
+#include <sys/resource.h>
+
+#include "../tree.h"
+
+using tree_t = std::tree<std::uint64_t>;
+using node_t = tree_t::node;
+
+/// @note: every heap allocation of the process goes through here so that allocs/op can be reported.
+static std::size_t __allocations = 0;
+
+void *operator new(std::size_t _n) {
+	++__allocations;
+	if (void *p = std::malloc(_n ? _n : 1))
+		return p;
+	throw std::bad_alloc();
+}
+void operator delete(void *_p) noexcept { std::free(_p); }
+void operator delete(void *_p, std::size_t) noexcept { std::free(_p); }
+
+/// @fn: peak resident set size of the process so far, in MiB.
+static double peak_rss() {
+	rusage usage {};
+	getrusage(RUSAGE_SELF, &usage);
+	return (double) usage.ru_maxrss / 1024.0;
+}
+
+/// @note: synthetic tree shapes, every builder moves subtrees into place (no deep copies).
+static node_t make_balanced(std::size_t _n, std::uint64_t &_value) {
+	node_t root(_value++);
+	std::size_t rest = _n - 1;
+	for (std::size_t i = 0; i < 4 && rest != 0; ++i) {
+		std::size_t share = (_n - 1) / 4 + (i < (_n - 1) % 4);
+		if (share != 0)
+			root.append(make_balanced(share, _value));
+		rest -= share;
+	}
+	return root;
+}
+
+static node_t make_chain(std::size_t _n, std::uint64_t &_value) {
+	node_t current(_value + _n - 1);
+	for (std::size_t i = _n - 1; i-- > 0;) {
+		node_t parent(_value + i);
+		parent.append(std::move(current));
+		current = std::move(parent);
+	}
+	_value += _n;
+	return current;
+}
+
+static node_t make_wide(std::size_t _n, std::uint64_t &_value) {
+	node_t root(_value++);
+	for (std::size_t i = 1; i < _n; ++i)
+		root.append(node_t(_value++));
+	return root;
+}
+
+static node_t make_random(std::size_t _n, std::mt19937_64 &_rng) {
+	node_t root(_rng());
+	for (std::size_t rest = _n - 1; rest != 0;) {
+		std::size_t share = 1 + _rng() % rest;
+		root.append(make_random(share, _rng));
+		rest -= share;
+	}
+	return root;
+}
+
+/// @note: a shape is a name and a builder.
+struct shape_t {
+	char const *name;
+	node_t (*build)(std::size_t);
+};
+
+static shape_t const shapes[] = {
+	{ "balanced", [](std::size_t n) { std::uint64_t v = 0; return make_balanced(n, v); } },
+	{ "chain", [](std::size_t n) { std::uint64_t v = 0; return make_chain(n, v); } },
+	{ "wide", [](std::size_t n) { std::uint64_t v = 0; return make_wide(n, v); } },
+	{ "random", [](std::size_t n) { std::mt19937_64 rng(n); return make_random(n, rng); } },
+};
+
+/// @fn: runs _op (after an untimed _setup) until ~100ms have been spent, and prints one row.
+template<typename _s_fn, typename _o_fn>
+static void measure(char const *_shape, std::size_t _n, char const *_op, _s_fn &&_setup, _o_fn &&_run) {
+	using clock = std::chrono::steady_clock;
+	std::chrono::nanoseconds spent { 0 };
+	std::size_t reps = 0, allocs = 0;
+	do {
+		_setup();
+		std::size_t before = __allocations;
+		auto start = clock::now();
+		_run();
+		spent += clock::now() - start;
+		allocs += __allocations - before;
+		++reps;
+	} while (spent < std::chrono::milliseconds(100) && reps < 1000);
+
+	double ns = (double) spent.count() / (double) reps;
+	std::printf("%-9s %9zu  %-20s %14.0f %10.2f %12.1f %10.1f\n", _shape, _n, _op, ns, ns / (double) _n,
+		(double) allocs / (double) reps, peak_rss());
+}
+
+int main(int argc, char **argv) {
+	std::size_t max = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 10000000;
+	char const *only = argc > 2 ? argv[2] : nullptr;
+	std::uint64_t sink = 0;
+
+	std::printf("%-9s %9s  %-20s %14s %10s %12s %10s\n", "shape", "nodes", "op", "ns/op", "ns/node", "allocs/op",
+		"peak MiB");
+	for (auto const &shape : shapes) {
+		if (only && std::strcmp(only, shape.name) != 0)
+			continue;
+		for (std::size_t n = 1000; n <= max; n *= 10) {
+			auto tree = std::make_unique<tree_t>(shape.build(n));
+			std::unique_ptr<tree_t> scratch;
+			auto none = [] {};
+
+			measure(shape.name, n, "append (build)", [&] { scratch.reset(); },
+				[&] { scratch = std::make_unique<tree_t>(shape.build(n)); });
+			scratch.reset();
+			measure(shape.name, n, "search (miss)", none,
+				[&] { sink += tree->search(~0ull) != nullptr; });
+
+			std::function<bool(std::uint64_t const &, std::uint64_t const &)> less =
+				[](std::uint64_t const &a, std::uint64_t const &b) { return a < b; };
+			measure(shape.name, n, "isort", [&] { scratch = std::make_unique<tree_t>(*tree); },
+				[&] { scratch->isort(less); });
+			scratch.reset();
+
+			/// the storage walks side by side: the generic iterator, then the traversal kernel with and
+			///	without prefetching.
+			measure(shape.name, n, "iterate (iterator)", none, [&] {
+				for (auto &v : *tree)
+					sink += v;
+			});
+			measure(shape.name, n, "traverse (plain)", none,
+				[&] { tree->traverse([&](std::uint64_t const &v) { sink += v; }, 0); });
+			measure(shape.name, n, "traverse (prefetch)", none,
+				[&] { tree->traverse([&](std::uint64_t const &v) { sink += v; }); });
+
+			measure(shape.name, n, "copy", [&] { scratch.reset(); },
+				[&] { scratch = std::make_unique<tree_t>(*tree); });
+			scratch.reset();
+		}
+	}
+	return sink == 1;
+}
@@ -27,38 +27,140 @@
 /// @uses: std::snprintf(), std::string
 #include <string>
 
+/// @uses: std::swprintf()
+#include <cwchar>
+
+/// @uses: std::memchr(), std::memcpy(), std::strlen()
+#include <cstring>
+
 /// @uses: std::shared_ptr, std::unique_ptr
 #include <memory>
 
 /// @uses: std::optional, std::nullopt
 #include <optional>
 
+#if __cplusplus >= 202002L
+/// @uses: std::string_view, std::basic_string_view<?>
+#include <string_view>
+
+/// @uses: std::array<?>
+#include <array>
+
+/// @uses: std::to_chars, std::chars_format
+#include <charconv>
+
+/// @uses: std::integral<?>, std::floating_point<?>, std::convertible_to<?>
+#include <concepts>
+
+/// @uses: std::index_sequence<?>
+#include <utility>
+
+/// @uses: std::output_iterator<?>, std::iter_difference_t<?>
+#include <iterator>
+
+/// @uses: std::copy_n
+#include <algorithm>
+
+/// @uses: std::bit_width
+#include <bit>
+
+/// @uses: std::numeric_limits<?>
+#include <limits>
+
+/// @uses: std::span<?>
+#include <span>
+
+/// @uses: std::invalid_argument, std::length_error
+#include <stdexcept>
+
+/// @uses: std::tuple<?>, std::apply, std::tuple_size<?>
+#include <tuple>
+
+/// @uses: std::ranges::input_range<?>, std::ranges::random_access_range<?>, std::ranges::contiguous_range<?>
+#include <ranges>
+
+/// @uses: std::vector<?>
+#include <vector>
+
+/// @uses: std::basic_ostream<?>
+#include <ostream>
+
+/// @uses: std::pmr::string, std::pmr::memory_resource, std::pmr::polymorphic_allocator<?>
+#include <memory_resource>
+
+/// @uses: std::is_constant_evaluated
+#include <type_traits>
+
+/// @uses: std::chrono::system_clock, std::chrono::time_point<?>, std::chrono::floor<?>
+#include <chrono>
+
+#if defined(__SSE2__) || defined(__AVX2__)
+/// @uses: _mm_cmpeq_epi8, _mm_movemask_epi8, _mm256_cmpeq_epi8, _mm256_movemask_epi8
+#include <immintrin.h>
+#endif
+
+#if defined(__x86_64__) || defined(__i386__)
+/// @uses: __rdtsc
+#include <x86intrin.h>
+
+/// @uses: __get_cpuid
+#include <cpuid.h>
+#endif
+#endif
+
 namespace std
 _GLIBCXX_VISIBILITY(default) {
+    /// @note: size (in characters) of the on-stack buffer the printf-style formatters try first; only output
+    ///     that does not fit pays for a heap buffer and a second pass.
+    inline constexpr std::size_t __vformat_stack = 512;
+
+    /// @note: upper bound for the wide formatters, swprintf cannot report the size it needs so they grow
+    ///     until the output fits (this stops them on an encoding error, which fails at any size).
+    inline constexpr std::size_t __wformat_max = 1ul << 24;
+
     /// @fn: formats a string (with a specified length).
     template<typename... pargs_t>
     _GLIBCXX_NODISCARD
     inline std::string
     vnformat(const std::string &_format, std::size_t _n, pargs_t... _args) {
-        if (auto sz = (std::size_t) std::snprintf(nullptr, 0, _format.c_str(), _args...) + 1; sz > 0 && _n != 0) {
-            std::unique_ptr<char[]> buf(new char[_n]);
-            std::snprintf(buf.get(), _n, _format.c_str(), _args...);
-            return std::string(buf.get(), buf.get() + _n - 1);
-        }
-        return {};
+        if (_n == 0)
+            return {};
+        char buf[__vformat_stack];
+        int len = std::snprintf(buf, sizeof(buf), _format.c_str(), _args...);
+        if (len < 0)
+            return {};
+        std::size_t keep = (std::size_t) len < _n - 1 ? (std::size_t) len : _n - 1;
+        if ((std::size_t) len < sizeof(buf))
+            return std::string(buf, keep);
+
+        /// too long for the stack, format straight into the result.
+        std::string s(keep, '\0');
+        std::snprintf(s.data(), keep + 1, _format.c_str(), _args...);
+        return s;
     }
 
     /// @fn: formats a string.
     template<typename... pargs_t>
     _GLIBCXX_NODISCARD
     inline std::string
-    vformat(const std::string _format, pargs_t... _args) {
-        if (auto sz = (std::size_t) std::snprintf(nullptr, 0, _format.c_str(), _args...) + 1; sz > 0) {
-            std::unique_ptr<char[]> buf(new char[sz]);
-            std::snprintf(buf.get(), sz, _format.c_str(), _args...);
-            return std::string(buf.get(), buf.get() + sz - 1);
-        }
-        return {};
+    vformat(const std::string &_format, pargs_t... _args) {
+        /// no conversion at all (strlen and memchr are vectorized), the output is the format itself up to
+        ///     its first NUL, where snprintf would stop too.
+        std::size_t n = std::strlen(_format.c_str());
+        if (!std::memchr(_format.data(), '%', n))
+            return n == _format.size() ? _format : std::string(_format.data(), n);
+
+        char buf[__vformat_stack];
+        int len = std::snprintf(buf, sizeof(buf), _format.c_str(), _args...);
+        if (len < 0)
+            return {};
+        if ((std::size_t) len < sizeof(buf))
+            return std::string(buf, (std::size_t) len);
+
+        /// too long for the stack, format straight into the result.
+        std::string s((std::size_t) len, '\0');
+        std::snprintf(s.data(), (std::size_t) len + 1, _format.c_str(), _args...);
+        return s;
     }
 
     /// @fn: formats a string (with std::optional).
@@ -75,23 +177,45 @@ _GLIBCXX_VISIBILITY(default) {
     _GLIBCXX_NODISCARD
     inline std::wstring
     wnformat(const std::wstring &_format, std::size_t _n, pargs_t... _args) {
-        if (auto sz = (std::size_t) std::swprintf(nullptr, 0, _format.c_str(), _args...) + 1; sz > 0 && _n != 0) {
-            std::unique_ptr<wchar_t[]> buf(new wchar_t[_n]);
-            std::swprintf(buf.get(), _n, _format.c_str(), _args...);
-            return std::wstring(buf.get(), buf.get() + _n - 1);
+        if (_n == 0)
+            return {};
+        wchar_t buf[__vformat_stack];
+        std::wstring heap;
+        wchar_t *out = buf;
+        if (_n > __vformat_stack) {
+            heap.resize(_n);
+            out = heap.data();
         }
-        return {};
+
+        /// swprintf fails (-1) when the output is cut short, but still leaves the first _n - 1 characters.
+        int len = std::swprintf(out, _n, _format.c_str(), _args...);
+        std::size_t keep = (std::size_t) len;
+        if (len < 0) {
+            const wchar_t *nul = std::char_traits<wchar_t>::find(out, _n - 1, L'\0');
+            keep = nul ? (std::size_t) (nul - out) : _n - 1;
+        }
+        if (out == buf)
+            return std::wstring(buf, keep);
+        heap.resize(keep);
+        return heap;
     }
 
     /// @fn: formats a non-unicode string.
     template<typename... pargs_t>
     _GLIBCXX_NODISCARD
     inline std::wstring
-    wformat(const std::wstring _format, pargs_t... _args) {
-        if (auto sz = (std::size_t) std::swprintf(nullptr, 0, _format.c_str(), _args...) + 1; sz > 0) {
-            std::unique_ptr<wchar_t[]> buf(new wchar_t[sz]);
-            std::swprintf(buf.get(), sz, _format.c_str(), _args...);
-            return std::wstring(buf.get(), buf.get() + sz - 1);
+    wformat(const std::wstring &_format, pargs_t... _args) {
+        wchar_t buf[__vformat_stack];
+        if (int len = std::swprintf(buf, __vformat_stack, _format.c_str(), _args...); len >= 0)
+            return std::wstring(buf, (std::size_t) len);
+
+        /// did not fit on the stack, grow on the heap until it does.
+        for (std::size_t cap = __vformat_stack * 8; cap <= __wformat_max; cap *= 8) {
+            std::wstring s(cap, L'\0');
+            if (int len = std::swprintf(s.data(), cap, _format.c_str(), _args...); len >= 0) {
+                s.resize((std::size_t) len);
+                return s;
+            }
         }
         return {};
     }
@@ -105,4 +229,2557 @@ _GLIBCXX_VISIBILITY(default) {
         return s.length() == 0 ? std::make_optional(s) : std::nullopt;
     }
 }
+
+#if __cplusplus >= 202002L
+namespace std
+_GLIBCXX_VISIBILITY(default) {
+    /// @note: output buffer that the formatting engine writes into; a sink only decides how it grows.
+    ///     growing may hand the characters off (flushing sinks) or hand out less room than asked for (fixed
+    ///     storage), the excess is then dropped and only counted, so that callers can still find out the
+    ///     full length.
+    class __fmt_buffer {
+    protected:
+        /// @field: storage currently written into.
+        char *_ptr;
+
+        /// @field: number of characters written, and capacity of the storage.
+        std::size_t _size = 0, _cap;
+
+        /// @field: number of characters already handed off by a flushing sink.
+        std::size_t _flushed = 0;
+
+        /// @field: number of characters that did not fit and were dropped.
+        std::size_t _lost = 0;
+
+        /// @field: false when _cap is nominal (a bare char * target only promises room for the output
+        ///     itself), nothing may then be stored past the characters that end up committed.
+        bool _slack = true;
+
+        _GLIBCXX20_CONSTEXPR __fmt_buffer(char *_p, std::size_t _c) _GLIBCXX_NOEXCEPT : _ptr(_p), _cap(_c) {}
+        ~__fmt_buffer() = default;
+
+        /// @fn: makes room for _n characters in total (or as many as the sink can hold).
+        virtual void _grow(std::size_t _n) = 0;
+
+        /// @fn: appends what did not fit into the storage, growing it piece by piece (kept out of line so
+        ///     that the fast path of append() stays small).
+        __attribute__((__noinline__)) void _append_slow(const char *_s, std::size_t _n) {
+            for (;;) {
+                std::size_t room = _cap - _size;
+                if (_n <= room)
+                    break;
+                if (room != 0)
+                    std::memcpy(_ptr + _size, _s, room);
+                _size += room, _s += room, _n -= room;
+                this->_grow(_size + _n);
+                if (_size == _cap) {
+                    _lost += _n;
+                    return;
+                }
+            }
+            std::memcpy(_ptr + _size, _s, _n);
+            _size += _n;
+        }
+
+    public:
+        __fmt_buffer(__fmt_buffer const &) = delete;
+        __fmt_buffer &operator=(__fmt_buffer const &) = delete;
+
+        /// @fn: appends a run of characters.
+        inline void append(const char *_s, std::size_t _n) {
+            if (_n <= _cap - _size) {
+                std::memcpy(_ptr + _size, _s, _n);
+                _size += _n;
+                return;
+            }
+            this->_append_slow(_s, _n);
+        }
+
+        /// @fn: appends a single character.
+        inline void push_back(char _c) {
+            if (_size == _cap)
+                this->_grow(_size + 1);
+            if (_size < _cap)
+                _ptr[_size++] = _c;
+            else
+                ++_lost;
+        }
+
+        /// @fn: hands out room for _n characters in place if the storage has it (nullptr otherwise), so that
+        ///     writers can produce their output directly in the buffer; commit() then claims what was used.
+        _GLIBCXX_NODISCARD inline char *try_reserve(std::size_t _n) _GLIBCXX_NOEXCEPT {
+            return _n <= _cap - _size ? _ptr + _size : nullptr;
+        }
+        inline void commit(std::size_t _n) _GLIBCXX_NOEXCEPT { _size += _n; }
+
+        /// @fn: try_reserve() for writers that store past what they commit (bulk over-stores); sinks whose
+        ///     capacity is nominal never hand that room out.
+        _GLIBCXX_NODISCARD inline char *try_reserve_slack(std::size_t _n) _GLIBCXX_NOEXCEPT {
+            return _slack ? this->try_reserve(_n) : nullptr;
+        }
+
+        /// @fn: makes room for _n more characters up front, so that try_reserve() keeps succeeding while
+        ///     they are written (a hint, sinks that cannot grow just flush or keep truncating).
+        inline void reserve(std::size_t _n) {
+            if (_n > _cap - _size)
+                this->_grow(_size + _n);
+        }
+
+        /// @fn: getters for the written characters (those still held in the storage).
+        _GLIBCXX_NODISCARD char *data() _GLIBCXX_NOEXCEPT { return _ptr; }
+        _GLIBCXX_NODISCARD std::size_t size() const _GLIBCXX_NOEXCEPT { return _size; }
+
+        /// @fn: number of characters the output would have had without truncation.
+        _GLIBCXX_NODISCARD std::size_t count() const _GLIBCXX_NOEXCEPT { return _flushed + _size + _lost; }
+
+        /// @fn: checks if anything had to be dropped.
+        _GLIBCXX_NODISCARD bool truncated() const _GLIBCXX_NOEXCEPT { return _lost != 0; }
+    };
+
+    /// @note: buffer that starts out in _N bytes of inline (stack) storage and moves to the heap when full.
+    template<std::size_t _N = 256>
+    class __fmt_memory_buffer final : public __fmt_buffer {
+    private:
+        /// @field: inline storage, and the heap storage once that has run out.
+        char _store[_N];
+        std::unique_ptr<char[]> _heap;
+
+        void _grow(std::size_t _n) override {
+            std::size_t cap = _n > _cap * 2 ? _n : _cap * 2;
+            std::unique_ptr<char[]> heap(new char[cap]);
+            std::memcpy(heap.get(), _ptr, _size);
+            _heap = std::move(heap);
+            _ptr = _heap.get();
+            _cap = cap;
+        }
+
+    public:
+        __fmt_memory_buffer() _GLIBCXX_NOEXCEPT : __fmt_buffer(_store, _N) {}
+    };
+
+    /// @note: buffer over caller-owned storage of a fixed size; it never allocates and truncates instead.
+    class __fmt_fixed_buffer final : public __fmt_buffer {
+    private:
+        void _grow(std::size_t) override {}
+
+    public:
+        __fmt_fixed_buffer(char *_p, std::size_t _n) _GLIBCXX_NOEXCEPT : __fmt_buffer(_p, _n) {}
+
+        /// @note: storage the caller sized for the whole output, its actual size is unknown.
+        explicit __fmt_fixed_buffer(char *_p) _GLIBCXX_NOEXCEPT : __fmt_buffer(_p, (std::size_t) -1 / 2) {
+            _slack = false;
+        }
+    };
+
+    /// @note: buffer that only counts, the output goes to a small scratch area that is thrown away.
+    class __fmt_counting_buffer final : public __fmt_buffer {
+    private:
+        char _store[64];
+
+        void _grow(std::size_t) override {
+            _flushed += _size;
+            _size = 0;
+        }
+
+    public:
+        __fmt_counting_buffer() _GLIBCXX_NOEXCEPT : __fmt_buffer(_store, sizeof(_store)) {}
+    };
+
+    /// @note: buffer that starts on the stack and moves into the result string (so into its allocator)
+    ///     once that runs out; finish() leaves exactly the output in the string.
+    template<typename _string>
+    class __fmt_string_buffer final : public __fmt_buffer {
+    private:
+        char _store[256];
+        _string &_str;
+
+        void _grow(std::size_t _n) override {
+            std::size_t cap = _n > _cap * 2 ? _n : _cap * 2;
+            _str.resize(cap);
+            if (_ptr == _store)
+                std::memcpy(_str.data(), _store, _size);
+            _ptr = _str.data();
+            _cap = cap;
+        }
+
+    public:
+        explicit __fmt_string_buffer(_string &_s) _GLIBCXX_NOEXCEPT : __fmt_buffer(_store, sizeof(_store)), _str(_s) {}
+
+        void finish() {
+            if (_ptr == _store)
+                _str.assign(_store, _size);
+            else
+                _str.resize(_size);
+        }
+    };
+
+    /// @note: heap buffer that keeps its storage from one use to the next (the per-thread buffers); storage
+    ///     that has grown past __fmt_reusable_keep is given back on the next reset, so one huge output does
+    ///     not stay allocated for the rest of the thread's life.
+    inline constexpr std::size_t __fmt_reusable_keep = std::size_t(1) << 20;
+
+    class __fmt_reusable_buffer final : public __fmt_buffer {
+    private:
+        std::unique_ptr<char[]> _heap;
+
+        void _grow(std::size_t _n) override {
+            std::size_t cap = _n > _cap * 2 ? _n : _cap * 2;
+            std::unique_ptr<char[]> heap(new char[cap]);
+            if (_size)
+                std::memcpy(heap.get(), _ptr, _size);
+            _heap = std::move(heap);
+            _ptr = _heap.get();
+            _cap = cap;
+        }
+
+    public:
+        __fmt_reusable_buffer() _GLIBCXX_NOEXCEPT : __fmt_buffer(nullptr, 0) {}
+
+        /// @fn: empties the buffer, keeping its storage unless that is over __fmt_reusable_keep (allocating
+        ///     anew on first use or after that).
+        void reset() {
+            _size = _flushed = _lost = 0;
+            if (_cap > __fmt_reusable_keep) {
+                _heap.reset();
+                _ptr = nullptr;
+                _cap = 0;
+            }
+            if (!_ptr)
+                _grow(256);
+        }
+    };
+
+    /// @note: the per-thread buffers, one per nesting level (a writer may itself format through them).
+    struct __fmt_thread_buffers {
+        std::array<__fmt_reusable_buffer, 4> _bufs;
+        std::size_t _depth = 0;
+    };
+
+    inline thread_local __fmt_thread_buffers __fmt_tls;
+
+    /// @note: claims the calling thread's buffer for the current nesting level until it goes out of scope.
+    struct __fmt_tls_guard {
+        __fmt_reusable_buffer &_buf;
+
+        __fmt_tls_guard() : _buf(_claim()) {}
+        ~__fmt_tls_guard() { --__fmt_tls._depth; }
+        __fmt_tls_guard(__fmt_tls_guard const &) = delete;
+
+        static __fmt_reusable_buffer &_claim() {
+            if (__fmt_tls._depth == __fmt_tls._bufs.size())
+                throw std::length_error("format: thread buffers nested too deeply");
+            __fmt_reusable_buffer &buf = __fmt_tls._bufs[__fmt_tls._depth];
+            buf.reset();
+            ++__fmt_tls._depth;
+            return buf;
+        }
+    };
+
+    /// @note: buffer that collects output in a small chunk and flushes it to an output iterator, writing
+    ///     at most _limit characters in total (the rest is only counted).
+    template<typename _out_it>
+    class __fmt_iterator_buffer final : public __fmt_buffer {
+    private:
+        /// @field: chunk, destination and the number of characters still allowed through.
+        char _store[256];
+        _out_it _it;
+        std::size_t _limit;
+
+        void _grow(std::size_t) override {
+            std::size_t n = _size < _limit ? _size : _limit;
+            _it = std::copy_n(_store, n, std::move(_it));
+            _limit -= n, _flushed += n, _lost += _size - n;
+            _size = 0;
+        }
+
+    public:
+        explicit __fmt_iterator_buffer(_out_it _out, std::size_t _n = (std::size_t) -1)
+            : __fmt_buffer(_store, sizeof(_store)), _it(std::move(_out)), _limit(_n) {}
+
+        /// @fn: flushes what is left and returns the iterator past the last written character.
+        _out_it out() {
+            this->_grow(0);
+            return std::move(_it);
+        }
+    };
+
+    /// @note: replacement field spec, `{[:[[fill]align][0][width][.precision][type]]}`, parsed at compile time.
+    struct __fmt_spec {
+        /// @field: presentation type, 0 for the default of the argument.
+        char _type = 0;
+
+        /// @field: precision, -1 when not given.
+        int _prec = -1;
+
+        /// @field: minimum width (0 for none), the fill character and the alignment ('<', '>', '^', or 0
+        ///     for the default of the argument: numbers to the right, the rest to the left).
+        int _width = 0;
+        char _fill = ' ';
+        char _align = 0;
+
+        /// @field: pad numbers with zeros after the sign (`{:08}`), unless an alignment is given.
+        bool _zero = false;
+    };
+
+    /// @note: codes of the presentation types that are longer than one letter (kept in __fmt_spec::_type,
+    ///     outside the range of the letters).
+    enum : char {
+        __fmt_type_base64 = 1,
+        __fmt_type_json,
+        __fmt_type_csv,
+        __fmt_type_sh,
+    };
+
+    /// @note: names of the multi letter presentation types, as they are written in a format string.
+    struct __fmt_named_type {
+        const char *_name;
+        char _code;
+    };
+
+    inline constexpr __fmt_named_type __fmt_named_types[] = {
+        { "b64", __fmt_type_base64 },
+        { "json", __fmt_type_json },
+        { "csv", __fmt_type_csv },
+        { "sh", __fmt_type_sh },
+    };
+
+    /// @note: literal run in front of a replacement field (or the tail after the last one).
+    struct __fmt_literal {
+        /// @field: offset and length inside the format string.
+        std::size_t _off = 0, _len = 0;
+
+        /// @field: number of doubled braces (`{{` / `}}`) in the run, each collapses to one on output.
+        std::size_t _esc = 0;
+    };
+
+    /// @note: writes one argument of type _ty; check() validates a spec for it at compile time and returns
+    ///     an error message (nullptr when fine), write() appends the formatted value, and the optional size()
+    ///     computes the length write() would produce without producing it.
+    template<typename _ty>
+    struct __fmt_writer;
+
+    /// @note: argument types as the engine sees them (arrays decay to pointers, no references or cv).
+    template<typename _ty>
+    using __fmt_arg_t = std::decay_t<_ty>;
+
+    /// @note: character types the engine treats as single characters rather than integers.
+    template<typename _ty>
+    concept __fmt_char = std::same_as<_ty, char> || std::same_as<_ty, signed char> || std::same_as<_ty, unsigned char>;
+
+    /// @note: wide code unit types, a wchar_t holds UTF-16 or UTF-32 depending on its size.
+    template<typename _ty>
+    concept __fmt_wide_char = std::same_as<_ty, wchar_t> || std::same_as<_ty, char16_t> || std::same_as<_ty, char32_t>;
+
+    /// @note: integral arguments (bool and the character types have writers of their own).
+    template<typename _ty>
+    concept __fmt_int = std::integral<_ty> && !std::same_as<_ty, bool> && !std::same_as<_ty, char> && !__fmt_wide_char<_ty>;
+
+    /// @fn: decodes UTF-8 into UTF-16 or UTF-32 code units (by the size of _u), invalid and truncated
+    ///     sequences decode to U+FFFD; runs of ASCII are widened 16 bytes at a time with SSE2.
+    /// @return: past the last unit written, _out needs room for (_last - _first) units.
+    template<__fmt_wide_char _u>
+    inline _u *__utf8_decode(const char *_first, const char *_last, _u *_out) _GLIBCXX_NOEXCEPT {
+        while (_first != _last) {
+#if defined(__SSE2__)
+            for (const __m128i zero = _mm_setzero_si128(); _last - _first >= 16; _first += 16, _out += 16) {
+                __m128i v = _mm_loadu_si128((const __m128i *) _first);
+                if (_mm_movemask_epi8(v) != 0)
+                    break;
+                __m128i lo = _mm_unpacklo_epi8(v, zero), hi = _mm_unpackhi_epi8(v, zero);
+                if constexpr (sizeof(_u) == 2) {
+                    _mm_storeu_si128((__m128i *) _out, lo);
+                    _mm_storeu_si128((__m128i *) (_out + 8), hi);
+                } else {
+                    _mm_storeu_si128((__m128i *) _out, _mm_unpacklo_epi16(lo, zero));
+                    _mm_storeu_si128((__m128i *) (_out + 4), _mm_unpackhi_epi16(lo, zero));
+                    _mm_storeu_si128((__m128i *) (_out + 8), _mm_unpacklo_epi16(hi, zero));
+                    _mm_storeu_si128((__m128i *) (_out + 12), _mm_unpackhi_epi16(hi, zero));
+                }
+            }
+            if (_first == _last)
+                break;
+#endif
+            auto c = (unsigned char) *_first++;
+            if (c < 0x80) {
+                *_out++ = (_u) c;
+                continue;
+            }
+
+            /// lead byte: number of continuation bytes and the smallest code point that may use them.
+            std::uint32_t cp = 0xfffd, v;
+            int n = c >= 0xc2 && c <= 0xdf ? 1 : c >= 0xe0 && c <= 0xef ? 2 : c >= 0xf0 && c <= 0xf4 ? 3 : 0;
+            if (n != 0 && _last - _first >= n) {
+                v = c & (0x7f >> (n + 1));
+                int k = 0;
+                for (; k < n && ((unsigned char) _first[k] & 0xc0) == 0x80; ++k)
+                    v = v << 6 | ((unsigned char) _first[k] & 0x3f);
+                if (k == n && v >= (n == 1 ? 0x80u : n == 2 ? 0x800u : 0x10000u) && v <= 0x10ffff
+                    && (v < 0xd800 || v > 0xdfff))
+                    cp = v, _first += n;
+            }
+            if (sizeof(_u) == 2 && cp >= 0x10000) {
+                *_out++ = (_u) (0xd800 + ((cp - 0x10000) >> 10));
+                *_out++ = (_u) (0xdc00 + ((cp - 0x10000) & 0x3ff));
+            } else
+                *_out++ = (_u) cp;
+        }
+        return _out;
+    }
+
+    /// @fn: encodes UTF-16 or UTF-32 code units (by the size of _u) as UTF-8, unpaired surrogates and
+    ///     out of range values encode U+FFFD; runs of ASCII are narrowed 16 units at a time with SSE2.
+    /// @return: past the last byte written, _out needs room for 3 (UTF-16) or 4 (UTF-32) bytes per unit.
+    template<__fmt_wide_char _u>
+    inline char *__utf8_encode(const _u *_first, const _u *_last, char *_out) _GLIBCXX_NOEXCEPT {
+        while (_first != _last) {
+#if defined(__SSE2__)
+            for (const __m128i zero = _mm_setzero_si128(); _last - _first >= 16; _first += 16, _out += 16) {
+                __m128i a = _mm_loadu_si128((const __m128i *) _first);
+                __m128i b = _mm_loadu_si128((const __m128i *) (_first + 16 / sizeof(_u)));
+                if constexpr (sizeof(_u) == 2) {
+                    __m128i high = _mm_and_si128(_mm_or_si128(a, b), _mm_set1_epi16((short) 0xff80));
+                    if (_mm_movemask_epi8(_mm_cmpeq_epi16(high, zero)) != 0xffff)
+                        break;
+                    _mm_storeu_si128((__m128i *) _out, _mm_packus_epi16(a, b));
+                } else {
+                    __m128i c = _mm_loadu_si128((const __m128i *) (_first + 8));
+                    __m128i d = _mm_loadu_si128((const __m128i *) (_first + 12));
+                    __m128i high = _mm_and_si128(_mm_or_si128(_mm_or_si128(a, b), _mm_or_si128(c, d)),
+                        _mm_set1_epi32((int) 0xffffff80));
+                    if (_mm_movemask_epi8(_mm_cmpeq_epi32(high, zero)) != 0xffff)
+                        break;
+                    _mm_storeu_si128((__m128i *) _out, _mm_packus_epi16(_mm_packs_epi32(a, b), _mm_packs_epi32(c, d)));
+                }
+            }
+            if (_first == _last)
+                break;
+#endif
+            auto cp = (std::uint32_t) *_first++;
+            if (cp < 0x80) {
+                *_out++ = (char) cp;
+                continue;
+            }
+            if (sizeof(_u) == 2 && cp >= 0xd800 && cp <= 0xdbff && _first != _last
+                && (std::uint32_t) *_first >= 0xdc00 && (std::uint32_t) *_first <= 0xdfff)
+                cp = 0x10000 + ((cp - 0xd800) << 10) + ((std::uint32_t) *_first++ - 0xdc00);
+            if ((cp >= 0xd800 && cp <= 0xdfff) || cp > 0x10ffff)
+                cp = 0xfffd;
+
+            if (cp < 0x800) {
+                _out[0] = (char) (0xc0 | cp >> 6);
+                _out[1] = (char) (0x80 | (cp & 0x3f));
+                _out += 2;
+            } else if (cp < 0x10000) {
+                _out[0] = (char) (0xe0 | cp >> 12);
+                _out[1] = (char) (0x80 | (cp >> 6 & 0x3f));
+                _out[2] = (char) (0x80 | (cp & 0x3f));
+                _out += 3;
+            } else {
+                _out[0] = (char) (0xf0 | cp >> 18);
+                _out[1] = (char) (0x80 | (cp >> 12 & 0x3f));
+                _out[2] = (char) (0x80 | (cp >> 6 & 0x3f));
+                _out[3] = (char) (0x80 | (cp & 0x3f));
+                _out += 4;
+            }
+        }
+        return _out;
+    }
+
+    /// @note: byte to two hex digits, lower and upper case.
+    inline constexpr auto __fmt_hex2 = []() {
+        std::array<char, 1024> d {};
+        for (int i = 0; i < 256; ++i) {
+            d[i * 2] = "0123456789abcdef"[i >> 4], d[i * 2 + 1] = "0123456789abcdef"[i & 15];
+            d[512 + i * 2] = "0123456789ABCDEF"[i >> 4], d[512 + i * 2 + 1] = "0123456789ABCDEF"[i & 15];
+        }
+        return d;
+    }();
+
+    inline constexpr char __fmt_base64_alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+#if defined(__SSE2__)
+    /// @fn: turns 16 nibbles (0..15, one per byte) into hex digits: '0' + n, plus the gap to the letters.
+    inline __m128i __fmt_hex_digits(__m128i _n, char _gap) _GLIBCXX_NOEXCEPT {
+        __m128i letters = _mm_and_si128(_mm_cmpgt_epi8(_n, _mm_set1_epi8(9)), _mm_set1_epi8(_gap));
+        return _mm_add_epi8(_mm_add_epi8(_n, _mm_set1_epi8('0')), letters);
+    }
+#endif
+
+    /// @fn: hex encodes _n bytes into 2 * _n digits: 32 / 16 bytes per step with AVX2 / SSE2 (split into
+    ///     nibbles, interleaved, mapped with one compare), a table for the tail.
+    /// @return: past the last digit written.
+    inline char *__fmt_hex_encode(char *_out, const unsigned char *_in, std::size_t _n, bool _upper) _GLIBCXX_NOEXCEPT {
+        std::size_t i = 0;
+#if defined(__SSE2__)
+        const char gap = _upper ? 'A' - '9' - 1 : 'a' - '9' - 1;
+#endif
+#if defined(__AVX2__)
+        {
+            const __m256i mask = _mm256_set1_epi8(0x0f);
+            const __m256i nine = _mm256_set1_epi8(9), zero = _mm256_set1_epi8('0'), letters = _mm256_set1_epi8(gap);
+            for (; _n - i >= 32; i += 32, _out += 64) {
+                /// reorder the quadwords so that the in-lane unpacks produce the digits in order.
+                __m256i v = _mm256_permute4x64_epi64(_mm256_loadu_si256((const __m256i *) (_in + i)), 0xd8);
+                __m256i hi = _mm256_and_si256(_mm256_srli_epi16(v, 4), mask), lo = _mm256_and_si256(v, mask);
+                __m256i a = _mm256_unpacklo_epi8(hi, lo), b = _mm256_unpackhi_epi8(hi, lo);
+                a = _mm256_add_epi8(_mm256_add_epi8(a, zero), _mm256_and_si256(_mm256_cmpgt_epi8(a, nine), letters));
+                b = _mm256_add_epi8(_mm256_add_epi8(b, zero), _mm256_and_si256(_mm256_cmpgt_epi8(b, nine), letters));
+                _mm256_storeu_si256((__m256i *) _out, a);
+                _mm256_storeu_si256((__m256i *) (_out + 32), b);
+            }
+        }
+#endif
+#if defined(__SSE2__)
+        for (const __m128i mask = _mm_set1_epi8(0x0f); _n - i >= 16; i += 16, _out += 32) {
+            __m128i v = _mm_loadu_si128((const __m128i *) (_in + i));
+            __m128i hi = _mm_and_si128(_mm_srli_epi16(v, 4), mask), lo = _mm_and_si128(v, mask);
+            _mm_storeu_si128((__m128i *) _out, __fmt_hex_digits(_mm_unpacklo_epi8(hi, lo), gap));
+            _mm_storeu_si128((__m128i *) (_out + 16), __fmt_hex_digits(_mm_unpackhi_epi8(hi, lo), gap));
+        }
+#endif
+        const char *table = __fmt_hex2.data() + (_upper ? 512 : 0);
+        for (; i < _n; ++i, _out += 2)
+            std::memcpy(_out, table + _in[i] * 2, 2);
+        return _out;
+    }
+
+#if defined(__SSSE3__)
+    /// @fn: base64 of the first 12 bytes of each 16-byte lane: the bytes are spread so that every 32-bit
+    ///     word holds one 3-byte group, the four 6-bit indices are moved into place with two multiplies,
+    ///     and mapped to the alphabet with a 16-entry offset table (one shuffle).
+    template<typename _v, typename _ops>
+    inline _v __fmt_base64_lane(_v _in, _ops _op) _GLIBCXX_NOEXCEPT {
+        _in = _op.shuffle(_in, _op.set(1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10));
+        _v t0 = _op.mulhi(_op.and_(_in, _op.set32(0x0fc0fc00)), _op.set32(0x04000040));
+        _v t1 = _op.mullo(_op.and_(_in, _op.set32(0x003f03f0)), _op.set32(0x01000010));
+        _v idx = _op.or_(t0, t1);
+
+        /// 0..25 -> 13, 26..51 -> 0, 52..63 -> 1..12: the slot of the offset to add.
+        _v slot = _op.subs(idx, _op.set8(51));
+        slot = _op.or_(slot, _op.and_(_op.cmpgt(_op.set8(26), idx), _op.set8(13)));
+        _v offsets = _op.set('a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+            '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0);
+        return _op.add(_op.shuffle(offsets, slot), idx);
+    }
+
+    struct __fmt_sse_ops {
+        static __m128i shuffle(__m128i a, __m128i b) { return _mm_shuffle_epi8(a, b); }
+        template<typename... _b>
+        static __m128i set(_b... b) { return _mm_setr_epi8((char) b...); }
+        static __m128i set8(char c) { return _mm_set1_epi8(c); }
+        static __m128i set32(int c) { return _mm_set1_epi32(c); }
+        static __m128i mulhi(__m128i a, __m128i b) { return _mm_mulhi_epu16(a, b); }
+        static __m128i mullo(__m128i a, __m128i b) { return _mm_mullo_epi16(a, b); }
+        static __m128i and_(__m128i a, __m128i b) { return _mm_and_si128(a, b); }
+        static __m128i or_(__m128i a, __m128i b) { return _mm_or_si128(a, b); }
+        static __m128i subs(__m128i a, __m128i b) { return _mm_subs_epu8(a, b); }
+        static __m128i cmpgt(__m128i a, __m128i b) { return _mm_cmpgt_epi8(a, b); }
+        static __m128i add(__m128i a, __m128i b) { return _mm_add_epi8(a, b); }
+    };
+#endif
+#if defined(__AVX2__)
+    struct __fmt_avx2_ops {
+        static __m256i shuffle(__m256i a, __m256i b) { return _mm256_shuffle_epi8(a, b); }
+        template<typename... _b>
+        static __m256i set(_b... b) { return _mm256_setr_epi8((char) b..., (char) b...); }
+        static __m256i set8(char c) { return _mm256_set1_epi8(c); }
+        static __m256i set32(int c) { return _mm256_set1_epi32(c); }
+        static __m256i mulhi(__m256i a, __m256i b) { return _mm256_mulhi_epu16(a, b); }
+        static __m256i mullo(__m256i a, __m256i b) { return _mm256_mullo_epi16(a, b); }
+        static __m256i and_(__m256i a, __m256i b) { return _mm256_and_si256(a, b); }
+        static __m256i or_(__m256i a, __m256i b) { return _mm256_or_si256(a, b); }
+        static __m256i subs(__m256i a, __m256i b) { return _mm256_subs_epu8(a, b); }
+        static __m256i cmpgt(__m256i a, __m256i b) { return _mm256_cmpgt_epi8(a, b); }
+        static __m256i add(__m256i a, __m256i b) { return _mm256_add_epi8(a, b); }
+    };
+#endif
+
+    /// @fn: base64 encodes _n bytes (standard alphabet, padded) into 4 * ceil(_n / 3) characters: 24 / 12
+    ///     bytes per step with AVX2 / SSSE3, a 3-byte scalar loop for the rest.
+    /// @return: past the last character written.
+    inline char *__fmt_base64_encode(char *_out, const unsigned char *_in, std::size_t _n) _GLIBCXX_NOEXCEPT {
+        std::size_t i = 0;
+#if defined(__AVX2__)
+        /// two 16-byte loads 12 bytes apart (so 28 bytes have to be readable).
+        for (; _n - i >= 28; i += 24, _out += 32) {
+            __m256i v = _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadu_si128((const __m128i *) (_in + i))),
+                _mm_loadu_si128((const __m128i *) (_in + i + 12)), 1);
+            _mm256_storeu_si256((__m256i *) _out, __fmt_base64_lane(v, __fmt_avx2_ops {}));
+        }
+#endif
+#if defined(__SSSE3__)
+        for (; _n - i >= 16; i += 12, _out += 16)
+            _mm_storeu_si128((__m128i *) _out, __fmt_base64_lane(_mm_loadu_si128((const __m128i *) (_in + i)), __fmt_sse_ops {}));
+#endif
+        for (; _n - i >= 3; i += 3, _out += 4) {
+            std::uint32_t v = (std::uint32_t) _in[i] << 16 | (std::uint32_t) _in[i + 1] << 8 | _in[i + 2];
+            _out[0] = __fmt_base64_alphabet[v >> 18];
+            _out[1] = __fmt_base64_alphabet[v >> 12 & 63];
+            _out[2] = __fmt_base64_alphabet[v >> 6 & 63];
+            _out[3] = __fmt_base64_alphabet[v & 63];
+        }
+        if (_n - i != 0) {
+            std::uint32_t v = (std::uint32_t) _in[i] << 16 | (_n - i == 2 ? (std::uint32_t) _in[i + 1] << 8 : 0);
+            _out[0] = __fmt_base64_alphabet[v >> 18];
+            _out[1] = __fmt_base64_alphabet[v >> 12 & 63];
+            _out[2] = _n - i == 2 ? __fmt_base64_alphabet[v >> 6 & 63] : '=';
+            _out[3] = '=';
+            _out += 4;
+        }
+        return _out;
+    }
+
+    /// @fn: checks if a presentation type is one of the byte encodings (hex or base64).
+    constexpr bool __fmt_is_encoding(char _type) _GLIBCXX_NOEXCEPT {
+        return _type == 'x' || _type == 'X' || _type == __fmt_type_base64;
+    }
+
+    /// @fn: length of _n bytes in one of the byte encodings.
+    constexpr std::size_t __fmt_encoded_size(std::size_t _n, char _type) _GLIBCXX_NOEXCEPT {
+        return _type == __fmt_type_base64 ? (_n + 2) / 3 * 4 : _n * 2;
+    }
+
+    /// @fn: appends bytes in one of the byte encodings, in place when the buffer has the room and in
+    ///     chunks (a multiple of 3 bytes, so that base64 only pads at the very end) otherwise.
+    inline void __fmt_append_encoded(__fmt_buffer &_out, const unsigned char *_in, std::size_t _n, char _type) {
+        auto encode = [&](char *_to, const unsigned char *_from, std::size_t _k) {
+            return _type == __fmt_type_base64 ? __fmt_base64_encode(_to, _from, _k) : __fmt_hex_encode(_to, _from, _k, _type == 'X');
+        };
+        if (char *p = _out.try_reserve(__fmt_encoded_size(_n, _type))) {
+            _out.commit((std::size_t) (encode(p, _in, _n) - p));
+            return;
+        }
+        char local[1024];
+        for (std::size_t i = 0; i < _n; i += 384) {
+            std::size_t k = std::min<std::size_t>(384, _n - i);
+            _out.append(local, (std::size_t) (encode(local, _in + i, k) - local));
+        }
+    }
+
+    /// @fn: checks if a presentation type is one of the escapings (json, csv, sh).
+    constexpr bool __fmt_is_escaping(char _type) _GLIBCXX_NOEXCEPT {
+        return _type == __fmt_type_json || _type == __fmt_type_csv || _type == __fmt_type_sh;
+    }
+
+    /// @fn: checks if a byte has to be escaped (json: quote, backslash, control characters), makes a
+    ///     field quoted (csv: comma, quote, line breaks) or the argument quoted (sh: anything but
+    ///     [A-Za-z0-9] and _@%+=:,./-).
+    template<char _type>
+    constexpr bool __fmt_needs_escape(unsigned char _c) _GLIBCXX_NOEXCEPT {
+        if constexpr (_type == __fmt_type_json)
+            return _c < 0x20 || _c == '"' || _c == '\\';
+        else if constexpr (_type == __fmt_type_csv)
+            return _c == ',' || _c == '"' || _c == '\r' || _c == '\n';
+        else
+            return !((unsigned char) ((_c | 0x20) - 'a') < 26 || (unsigned char) (_c - '0') < 10 || _c == '_' || _c == '@'
+                || _c == '%' || _c == '+' || _c == '=' || _c == ':' || _c == ',' || _c == '.' || _c == '/' || _c == '-');
+    }
+
+#if defined(__SSE2__)
+    /// @fn: the same test on 16 bytes at once, one mask bit per byte that needs escaping (unsigned ranges
+    ///     are tested with min: x <= k exactly when min(x, k) == x).
+    template<char _type>
+    inline int __fmt_escape_mask(__m128i _v) _GLIBCXX_NOEXCEPT {
+        auto eq = [&](char _c) { return _mm_cmpeq_epi8(_v, _mm_set1_epi8(_c)); };
+        auto le = [](__m128i _x, char _k) { return _mm_cmpeq_epi8(_mm_min_epu8(_x, _mm_set1_epi8(_k)), _x); };
+        __m128i m;
+        if constexpr (_type == __fmt_type_json)
+            m = _mm_or_si128(_mm_or_si128(le(_v, 0x1f), eq('"')), eq('\\'));
+        else if constexpr (_type == __fmt_type_csv)
+            m = _mm_or_si128(_mm_or_si128(eq(','), eq('"')), _mm_or_si128(eq('\r'), eq('\n')));
+        else {
+            __m128i alpha = le(_mm_sub_epi8(_mm_or_si128(_v, _mm_set1_epi8(0x20)), _mm_set1_epi8('a')), 25);
+            __m128i safe = _mm_or_si128(alpha, le(_mm_sub_epi8(_v, _mm_set1_epi8('0')), 9));
+            safe = _mm_or_si128(safe, _mm_or_si128(_mm_or_si128(eq('_'), eq('@')), _mm_or_si128(eq('%'), eq('+'))));
+            safe = _mm_or_si128(safe, _mm_or_si128(_mm_or_si128(eq('='), eq(':')), _mm_or_si128(eq(','), eq('.'))));
+            safe = _mm_or_si128(safe, _mm_or_si128(eq('/'), eq('-')));
+            return ~_mm_movemask_epi8(safe) & 0xffff;
+        }
+        return _mm_movemask_epi8(m);
+    }
+#endif
+#if defined(__AVX2__)
+    template<char _type>
+    inline unsigned __fmt_escape_mask(__m256i _v) _GLIBCXX_NOEXCEPT {
+        auto eq = [&](char _c) { return _mm256_cmpeq_epi8(_v, _mm256_set1_epi8(_c)); };
+        auto le = [](__m256i _x, char _k) { return _mm256_cmpeq_epi8(_mm256_min_epu8(_x, _mm256_set1_epi8(_k)), _x); };
+        __m256i m;
+        if constexpr (_type == __fmt_type_json)
+            m = _mm256_or_si256(_mm256_or_si256(le(_v, 0x1f), eq('"')), eq('\\'));
+        else if constexpr (_type == __fmt_type_csv)
+            m = _mm256_or_si256(_mm256_or_si256(eq(','), eq('"')), _mm256_or_si256(eq('\r'), eq('\n')));
+        else {
+            __m256i alpha = le(_mm256_sub_epi8(_mm256_or_si256(_v, _mm256_set1_epi8(0x20)), _mm256_set1_epi8('a')), 25);
+            __m256i safe = _mm256_or_si256(alpha, le(_mm256_sub_epi8(_v, _mm256_set1_epi8('0')), 9));
+            safe = _mm256_or_si256(safe, _mm256_or_si256(_mm256_or_si256(eq('_'), eq('@')), _mm256_or_si256(eq('%'), eq('+'))));
+            safe = _mm256_or_si256(safe, _mm256_or_si256(_mm256_or_si256(eq('='), eq(':')), _mm256_or_si256(eq(','), eq('.'))));
+            safe = _mm256_or_si256(safe, _mm256_or_si256(eq('/'), eq('-')));
+            return ~(unsigned) _mm256_movemask_epi8(safe);
+        }
+        return (unsigned) _mm256_movemask_epi8(m);
+    }
+#endif
+
+    /// @fn: length of the clean run at the start of _p (bytes that need no escaping), 32 / 16 bytes per
+    ///     step with AVX2 / SSE2.
+    template<char _type>
+    inline std::size_t __fmt_clean_run(const char *_p, std::size_t _n) _GLIBCXX_NOEXCEPT {
+        std::size_t i = 0;
+#if defined(__AVX2__)
+        for (; _n - i >= 32; i += 32)
+            if (unsigned m = __fmt_escape_mask<_type>(_mm256_loadu_si256((const __m256i *) (_p + i))))
+                return i + (std::size_t) __builtin_ctz(m);
+#endif
+#if defined(__SSE2__)
+        for (; _n - i >= 16; i += 16)
+            if (int m = __fmt_escape_mask<_type>(_mm_loadu_si128((const __m128i *) (_p + i))))
+                return i + (std::size_t) __builtin_ctz((unsigned) m);
+#endif
+        while (i < _n && !__fmt_needs_escape<_type>((unsigned char) _p[i]))
+            ++i;
+        return i;
+    }
+
+    /// @fn: appends a string with every occurrence of _c doubled up / replaced by _with (csv and sh quoting).
+    inline void __fmt_append_replacing(__fmt_buffer &_out, std::string_view _v, char _c, std::string_view _with) {
+        for (std::size_t pos = 0;;) {
+            std::size_t hit = _v.find(_c, pos);
+            if (hit == std::string_view::npos) {
+                _out.append(_v.data() + pos, _v.size() - pos);
+                return;
+            }
+            _out.append(_v.data() + pos, hit - pos);
+            _out.append(_with.data(), _with.size());
+            pos = hit + 1;
+        }
+    }
+
+    /// @fn: appends a string escaped on the way: clean runs are copied in bulk, only the bytes that need it
+    ///     take the slow path.
+    ///     - json: the contents of a JSON string (without the quotes): \", \\, \n, \r, \t, \b, \f and \u00XX.
+    ///     - csv: an RFC 4180 field, quoted (with quotes doubled) only when it holds a comma, quote or line break.
+    ///     - sh: a POSIX shell word, single quoted (with ' as '\'') unless it is made only of safe characters.
+    inline void __fmt_append_escaped(__fmt_buffer &_out, std::string_view _v, char _type) {
+        if (_type == __fmt_type_json) {
+            for (std::size_t pos = 0; pos < _v.size();) {
+                std::size_t run = __fmt_clean_run<__fmt_type_json>(_v.data() + pos, _v.size() - pos);
+                _out.append(_v.data() + pos, run);
+                if ((pos += run) == _v.size())
+                    break;
+                unsigned char c = (unsigned char) _v[pos++];
+                char esc[6] = { '\\', (char) c };
+                std::size_t len = 2;
+                switch (c) {
+                    case '\n': esc[1] = 'n'; break;
+                    case '\r': esc[1] = 'r'; break;
+                    case '\t': esc[1] = 't'; break;
+                    case '\b': esc[1] = 'b'; break;
+                    case '\f': esc[1] = 'f'; break;
+                    case '"': case '\\': break;
+                    default:
+                        std::memcpy(esc + 1, "u00", 3);
+                        esc[4] = "0123456789abcdef"[c >> 4], esc[5] = "0123456789abcdef"[c & 15];
+                        len = 6;
+                }
+                _out.append(esc, len);
+            }
+        }
+        else if (_type == __fmt_type_csv) {
+            if (__fmt_clean_run<__fmt_type_csv>(_v.data(), _v.size()) == _v.size()) {
+                _out.append(_v.data(), _v.size());
+                return;
+            }
+            _out.push_back('"');
+            __fmt_append_replacing(_out, _v, '"', "\"\"");
+            _out.push_back('"');
+        }
+        else {
+            if (!_v.empty() && __fmt_clean_run<__fmt_type_sh>(_v.data(), _v.size()) == _v.size()) {
+                _out.append(_v.data(), _v.size());
+                return;
+            }
+            _out.push_back('\'');
+            __fmt_append_replacing(_out, _v, '\'', "'\\''");
+            _out.push_back('\'');
+        }
+    }
+
+    /// @fn: appends wide text to a buffer as UTF-8, in place when there is room and in chunks otherwise.
+    template<__fmt_wide_char _u>
+    inline void __fmt_append_utf8(__fmt_buffer &_out, const _u *_first, const _u *_last) {
+        constexpr std::size_t __max = sizeof(_u) == 2 ? 3 : 4;
+        if (char *p = _out.try_reserve((std::size_t) (_last - _first) * __max)) {
+            _out.commit((std::size_t) (__utf8_encode(_first, _last, p) - p));
+            return;
+        }
+        char local[65 * __max];
+        while (_first != _last) {
+            const _u *mid = _last - _first > 64 ? _first + 64 : _last;
+
+            /// never split a surrogate pair between two chunks.
+            if (sizeof(_u) == 2 && mid != _last && (std::uint32_t) mid[-1] >= 0xd800 && (std::uint32_t) mid[-1] <= 0xdbff)
+                ++mid;
+            _out.append(local, (std::size_t) (__utf8_encode(_first, mid, local) - local));
+            _first = mid;
+        }
+    }
+
+    /// @note: two decimal digits per entry, "00" through "99".
+    inline constexpr auto __fmt_digits2 = []() {
+        std::array<char, 200> d {};
+        for (int i = 0; i < 100; ++i)
+            d[i * 2] = (char) ('0' + i / 10), d[i * 2 + 1] = (char) ('0' + i % 10);
+        return d;
+    }();
+
+    /// @note: powers of ten used to correct the digit estimate (the 0th entry is 0 so that 0 has one digit).
+    inline constexpr std::uint64_t __fmt_pow10[20] = {
+        0, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000, 10000000000ull,
+        100000000000ull, 1000000000000ull, 10000000000000ull, 100000000000000ull, 1000000000000000ull,
+        10000000000000000ull, 100000000000000000ull, 1000000000000000000ull, 10000000000000000000ull,
+    };
+
+    /// @fn: number of decimal digits in _v, without a loop: the bit width times log10(2) (1233 / 4096)
+    ///     is either exact or one too many, which one compare against a power of ten fixes.
+    constexpr int __fmt_count_digits(std::uint64_t _v) _GLIBCXX_NOEXCEPT {
+        int t = (std::bit_width(_v | 1) * 1233) >> 12;
+        return t + 1 - (_v < __fmt_pow10[t]);
+    }
+
+    /// @fn: number of digits in _v for a power of two base (1 << _shift).
+    constexpr int __fmt_count_digits_pow2(std::uint64_t _v, int _shift) _GLIBCXX_NOEXCEPT {
+        return (std::bit_width(_v | 1) + _shift - 1) / _shift;
+    }
+
+    /// @fn: writes the _n decimal digits of _v to _out, two at a time from the back.
+    inline void __fmt_write_dec(char *_out, std::uint64_t _v, int _n) _GLIBCXX_NOEXCEPT {
+        char *p = _out + _n;
+        while (_v >= 100) {
+            p -= 2;
+            std::memcpy(p, __fmt_digits2.data() + (_v % 100) * 2, 2);
+            _v /= 100;
+        }
+        if (_v >= 10)
+            std::memcpy(p - 2, __fmt_digits2.data() + _v * 2, 2);
+        else
+            p[-1] = (char) ('0' + _v);
+    }
+
+    /// @fn: writes the _n digits of _v in base (1 << _shift) to _out, from the back.
+    inline void __fmt_write_pow2(char *_out, std::uint64_t _v, int _n, int _shift, bool _upper) _GLIBCXX_NOEXCEPT {
+        const char *digits = _upper ? "0123456789ABCDEF" : "0123456789abcdef";
+        std::uint64_t mask = (1u << _shift) - 1;
+        for (char *p = _out + _n; p != _out; _v >>= _shift)
+            *--p = digits[_v & mask];
+    }
+
+    /// @fn: decimal lengths (sign included) of a block of integers; 32-bit values are counted four at a
+    ///     time with SSE2 (nine compares against the powers of ten, no branches), the others one at a time.
+    /// @return: the total length of the block.
+    template<typename _ty>
+    inline std::size_t __fmt_count_digits_block(_ty const *_v, std::size_t _n, unsigned char *_len) _GLIBCXX_NOEXCEPT {
+        std::size_t total = 0, i = 0;
+#if defined(__SSE2__)
+        if constexpr (sizeof(_ty) == sizeof(std::uint32_t)) {
+            /// unsigned compares through the signed ones, both sides biased by 2^31.
+            const __m128i bias = _mm_set1_epi32(INT32_MIN), zero = _mm_setzero_si128();
+            __m128i sum = zero;
+            for (; _n - i >= 4; i += 4) {
+                __m128i v = _mm_loadu_si128((const __m128i *) (_v + i)), d = _mm_set1_epi32(1);
+                if constexpr (std::is_signed_v<_ty>) {
+                    __m128i neg = _mm_srai_epi32(v, 31);
+                    v = _mm_sub_epi32(_mm_xor_si128(v, neg), neg);
+                    d = _mm_sub_epi32(d, neg);
+                }
+                v = _mm_xor_si128(v, bias);
+                for (int k = 1; k < 10; ++k)
+                    d = _mm_sub_epi32(d, _mm_cmpgt_epi32(v, _mm_set1_epi32((int) (((std::uint32_t) __fmt_pow10[k] - 1) ^ 0x80000000u))));
+                sum = _mm_add_epi32(sum, d);
+                int bytes = _mm_cvtsi128_si32(_mm_packus_epi16(_mm_packs_epi32(d, zero), zero));
+                std::memcpy(_len + i, &bytes, sizeof(bytes));
+            }
+            sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0x4e));
+            sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0xb1));
+            total = (std::uint32_t) _mm_cvtsi128_si32(sum);
+        }
+#endif
+        for (; i < _n; ++i) {
+            auto u = (std::uint64_t) _v[i];
+            bool neg = false;
+            if constexpr (std::is_signed_v<_ty>) {
+                neg = _v[i] < 0;
+                u = neg ? 0 - (std::uint64_t) (std::int64_t) _v[i] : u;
+            }
+            _len[i] = (unsigned char) (__fmt_count_digits(u) + neg);
+            total += _len[i];
+        }
+        return total;
+    }
+
+    /// @fn: writes exactly _N (even) decimal digits of _v, leading zeros included, with no data dependent branch.
+    template<int _N>
+    inline void __fmt_write_dec_fixed(char *_out, std::uint32_t _v) _GLIBCXX_NOEXCEPT {
+        for (int i = _N; i > 0; i -= 2) {
+            std::memcpy(_out + i - 2, __fmt_digits2.data() + (_v % 100) * 2, 2);
+            _v /= 100;
+        }
+    }
+
+    /// @fn: log2 of the base a presentation type asks for (0 for decimal).
+    constexpr int __fmt_base_shift(char _type) _GLIBCXX_NOEXCEPT {
+        return _type == 'x' || _type == 'X' ? 4 : _type == 'o' ? 3 : _type == 'b' ? 1 : 0;
+    }
+
+    /// @fn: number of digits __fmt_write_uint produces for _v (without the sign).
+    constexpr int __fmt_uint_size(std::uint64_t _v, char _type) _GLIBCXX_NOEXCEPT {
+        int shift = __fmt_base_shift(_type);
+        return shift ? __fmt_count_digits_pow2(_v, shift) : __fmt_count_digits(_v);
+    }
+
+    /// @fn: writes an integer (sign included) in the base a presentation type asks for; the length is
+    ///     known up front, so the digits go straight into the buffer whenever it has the room.
+    inline void __fmt_write_uint(__fmt_buffer &_out, std::uint64_t _v, bool _neg, char _type) {
+        int shift = __fmt_base_shift(_type);
+        int n = __fmt_uint_size(_v, _type);
+        std::size_t total = (std::size_t) n + _neg;
+
+        char local[66];
+        char *p = _out.try_reserve(total);
+        char *dst = p ? p : local;
+        dst[0] = '-';
+        if (shift)
+            __fmt_write_pow2(dst + _neg, _v, n, shift, _type == 'X');
+        else
+            __fmt_write_dec(dst + _neg, _v, n);
+        if (p)
+            _out.commit(total);
+        else
+            _out.append(local, total);
+    }
+
+    template<__fmt_int _ty>
+    struct __fmt_writer<_ty> {
+        static constexpr const char *check(__fmt_spec const &_s) {
+            switch (_s._type) {
+                case 0: case 'd': case 'x': case 'X': case 'b': case 'o':
+                    return _s._prec < 0 ? nullptr : "precision not allowed for an integer";
+                default: return "invalid presentation type for an integer";
+            }
+        }
+        static void write(__fmt_buffer &_out, _ty _v, __fmt_spec const &_s) {
+            if constexpr (sizeof(_ty) > sizeof(std::uint64_t)) {
+                /// wider than the kernels handle (__int128), rare enough for to_chars.
+                char buf[sizeof(_ty) * 8 + 1];
+                int base = _s._type == 'x' || _s._type == 'X' ? 16 : _s._type == 'b' ? 2 : _s._type == 'o' ? 8 : 10;
+                char *end = std::to_chars(buf, buf + sizeof(buf), _v, base).ptr;
+                if (_s._type == 'X')
+                    for (char *c = buf; c != end; ++c)
+                        *c = *c >= 'a' ? (char) (*c - 'a' + 'A') : *c;
+                _out.append(buf, (std::size_t) (end - buf));
+            } else if constexpr (std::is_signed_v<_ty>) {
+                /// negate in unsigned arithmetic so that the minimum value does not overflow.
+                std::uint64_t u = (std::uint64_t) (std::int64_t) _v;
+                __fmt_write_uint(_out, _v < 0 ? 0 - u : u, _v < 0, _s._type);
+            } else
+                __fmt_write_uint(_out, (std::uint64_t) _v, false, _s._type);
+        }
+        static std::size_t size(_ty _v, __fmt_spec const &_s) requires (sizeof(_ty) <= sizeof(std::uint64_t)) {
+            if constexpr (std::is_signed_v<_ty>) {
+                std::uint64_t u = (std::uint64_t) (std::int64_t) _v;
+                return (std::size_t) __fmt_uint_size(_v < 0 ? 0 - u : u, _s._type) + (_v < 0);
+            } else
+                return (std::size_t) __fmt_uint_size((std::uint64_t) _v, _s._type);
+        }
+    };
+
+    template<>
+    struct __fmt_writer<bool> {
+        static constexpr const char *check(__fmt_spec const &_s) {
+            if (_s._prec >= 0)
+                return "precision not allowed for a bool";
+            return _s._type == 0 || _s._type == 's' || _s._type == 'd' ? nullptr : "invalid presentation type for a bool";
+        }
+        static void write(__fmt_buffer &_out, bool _v, __fmt_spec const &_s) {
+            if (_s._type == 'd')
+                _out.push_back(_v ? '1' : '0');
+            else if (_v)
+                _out.append("true", 4);
+            else
+                _out.append("false", 5);
+        }
+        static std::size_t size(bool _v, __fmt_spec const &_s) {
+            return _s._type == 'd' ? 1 : _v ? 4 : 5;
+        }
+    };
+
+    template<>
+    struct __fmt_writer<char> {
+        static constexpr const char *check(__fmt_spec const &_s) {
+            if (_s._prec >= 0)
+                return "precision not allowed for a character";
+            return _s._type == 0 || _s._type == 'c' ? nullptr : __fmt_writer<int>::check(_s);
+        }
+        static void write(__fmt_buffer &_out, char _v, __fmt_spec const &_s) {
+            if (_s._type == 0 || _s._type == 'c')
+                _out.push_back(_v);
+            else
+                __fmt_writer<int>::write(_out, (int) _v, _s);
+        }
+        static std::size_t size(char _v, __fmt_spec const &_s) {
+            return _s._type == 0 || _s._type == 'c' ? 1 : __fmt_writer<int>::size((int) _v, _s);
+        }
+    };
+
+    /// @note: floating point writer on top of std::to_chars (shortest round-trip, locale independent):
+    ///     `{}` is the shortest text that reads back to the same value, `{:e}` / `{:f}` / `{:g}` the shortest
+    ///     in that notation, and a precision (`{:.3f}`) switches to exactly that many digits; `{:a}` is hex
+    ///     and the upper case types upper case the output.
+    template<std::floating_point _ty>
+    struct __fmt_writer<_ty> {
+        static constexpr const char *check(__fmt_spec const &_s) {
+            switch (_s._type) {
+                case 0: case 'g': case 'G': case 'e': case 'E': case 'f': case 'F': case 'a': case 'A': return nullptr;
+                default: return "invalid presentation type for a floating point number";
+            }
+        }
+        static std::to_chars_result convert(char *_first, char *_last, _ty _v, __fmt_spec const &_s) {
+            std::chars_format fmt = std::chars_format::general;
+            switch (_s._type) {
+                case 0:
+                    if (_s._prec < 0)
+                        return std::to_chars(_first, _last, _v);
+                    break;
+                case 'e': case 'E': fmt = std::chars_format::scientific; break;
+                case 'f': case 'F': fmt = std::chars_format::fixed; break;
+                case 'a': case 'A': fmt = std::chars_format::hex; break;
+            }
+            return _s._prec < 0 ? std::to_chars(_first, _last, _v, fmt) : std::to_chars(_first, _last, _v, fmt, _s._prec);
+        }
+        /// @fn: converts into _local, or into _heap when that is too small, upper casing it there for the
+        ///     upper case types; returns the text.
+        static std::string_view render(char (&_local)[128], std::unique_ptr<char[]> &_heap, _ty _v, __fmt_spec const &_s) {
+            char *first = _local;
+            auto r = convert(_local, _local + sizeof(_local), _v, _s);
+
+            /// only large fixed values or large precisions get here.
+            for (std::size_t cap = sizeof(_local) * 8; r.ec != std::errc(); cap *= 4) {
+                _heap.reset(new char[cap]);
+                first = _heap.get();
+                r = convert(first, first + cap, _v, _s);
+            }
+            if (_s._type >= 'A' && _s._type <= 'Z')
+                for (char *c = first; c != r.ptr; ++c)
+                    *c = *c >= 'a' && *c <= 'z' ? (char) (*c - 'a' + 'A') : *c;
+            return { first, (std::size_t) (r.ptr - first) };
+        }
+        static void write(__fmt_buffer &_out, _ty _v, __fmt_spec const &_s) {
+            char local[128];
+            std::unique_ptr<char[]> heap;
+            std::string_view text = render(local, heap, _v, _s);
+            _out.append(text.data(), text.size());
+        }
+        /// @note: the digits are the size, so this converts (into scratch) but skips the output buffer.
+        static std::size_t size(_ty _v, __fmt_spec const &_s) {
+            char local[128];
+            std::unique_ptr<char[]> heap;
+            return render(local, heap, _v, _s).size();
+        }
+    };
+
+    /// @note: strings are written as they are, their bytes hex (`{:x}` / `{:X}`) or base64 (`{:b64}`)
+    ///     encoded, or escaped for JSON, CSV or a shell (`{:json}`, `{:csv}`, `{:sh}`); a precision is the
+    ///     maximum number of characters (bytes) taken from the string.
+    template<>
+    struct __fmt_writer<std::string_view> {
+        static constexpr const char *check(__fmt_spec const &_s) {
+            return _s._type == 0 || _s._type == 's' || __fmt_is_encoding(_s._type) || __fmt_is_escaping(_s._type)
+                ? nullptr : "invalid presentation type for a string";
+        }
+        static void write(__fmt_buffer &_out, std::string_view _v, __fmt_spec const &_s) {
+            if (_s._prec >= 0 && (std::size_t) _s._prec < _v.size())
+                _v = _v.substr(0, (std::size_t) _s._prec);
+            if (__fmt_is_encoding(_s._type))
+                __fmt_append_encoded(_out, (const unsigned char *) _v.data(), _v.size(), _s._type);
+            else if (__fmt_is_escaping(_s._type))
+                __fmt_append_escaped(_out, _v, _s._type);
+            else
+                _out.append(_v.data(), _v.size());
+        }
+        static std::size_t size(std::string_view _v, __fmt_spec const &_s) {
+            if (__fmt_is_escaping(_s._type)) {
+                __fmt_counting_buffer buf;
+                write(buf, _v, _s);
+                return buf.count();
+            }
+            std::size_t n = _s._prec >= 0 && (std::size_t) _s._prec < _v.size() ? (std::size_t) _s._prec : _v.size();
+            return __fmt_is_encoding(_s._type) ? __fmt_encoded_size(n, _s._type) : n;
+        }
+    };
+
+    template<>
+    struct __fmt_writer<std::string> : __fmt_writer<std::string_view> {};
+
+    template<>
+    struct __fmt_writer<const char *> : __fmt_writer<std::string_view> {
+        static void write(__fmt_buffer &_out, const char *_v, __fmt_spec const &_s) {
+            __fmt_writer<std::string_view>::write(_out, _v ? std::string_view(_v) : std::string_view("(null)"), _s);
+        }
+        static std::size_t size(const char *_v, __fmt_spec const &_s) {
+            return __fmt_writer<std::string_view>::size(_v ? std::string_view(_v) : std::string_view("(null)"), _s);
+        }
+    };
+
+    template<>
+    struct __fmt_writer<char *> : __fmt_writer<const char *> {};
+
+    /// @note: wide characters are written as UTF-8 (or as integers with an integer presentation type).
+    template<__fmt_wide_char _ty>
+    struct __fmt_writer<_ty> {
+        static constexpr const char *check(__fmt_spec const &_s) {
+            return __fmt_writer<char>::check(_s);
+        }
+        static void write(__fmt_buffer &_out, _ty _v, __fmt_spec const &_s) {
+            if (_s._type == 0 || _s._type == 'c')
+                __fmt_append_utf8(_out, &_v, &_v + 1);
+            else
+                __fmt_writer<std::uint32_t>::write(_out, (std::uint32_t) _v, _s);
+        }
+    };
+
+    /// @note: wide strings are transcoded to UTF-8 as they are written, a precision counts code units.
+    template<__fmt_wide_char _u>
+    struct __fmt_writer<std::basic_string_view<_u>> {
+        static constexpr const char *check(__fmt_spec const &_s) {
+            return _s._type == 0 || _s._type == 's' ? nullptr : "invalid presentation type for a string";
+        }
+        static void write(__fmt_buffer &_out, std::basic_string_view<_u> _v, __fmt_spec const &_s) {
+            if (_s._prec >= 0 && (std::size_t) _s._prec < _v.size())
+                _v = _v.substr(0, (std::size_t) _s._prec);
+            __fmt_append_utf8(_out, _v.data(), _v.data() + _v.size());
+        }
+    };
+
+    template<__fmt_wide_char _u>
+    struct __fmt_writer<std::basic_string<_u>> : __fmt_writer<std::basic_string_view<_u>> {};
+
+    template<__fmt_wide_char _u>
+    struct __fmt_writer<const _u *> : __fmt_writer<std::basic_string_view<_u>> {
+        static void write(__fmt_buffer &_out, const _u *_v, __fmt_spec const &_s) {
+            if (_v)
+                __fmt_writer<std::basic_string_view<_u>>::write(_out, _v, _s);
+            else
+                __fmt_writer<const char *>::write(_out, nullptr, _s);
+        }
+    };
+
+    template<__fmt_wide_char _u>
+    struct __fmt_writer<_u *> : __fmt_writer<const _u *> {};
+
+    template<>
+    struct __fmt_writer<const void *> {
+        static constexpr const char *check(__fmt_spec const &_s) {
+            if (_s._prec >= 0)
+                return "precision not allowed for a pointer";
+            return _s._type == 0 || _s._type == 'p' ? nullptr : "invalid presentation type for a pointer";
+        }
+        static void write(__fmt_buffer &_out, const void *_v, __fmt_spec const &) {
+            _out.append("0x", 2);
+            __fmt_write_uint(_out, (std::uintptr_t) _v, false, 'x');
+        }
+        static std::size_t size(const void *_v, __fmt_spec const &) {
+            return 2 + (std::size_t) __fmt_uint_size((std::uintptr_t) _v, 'x');
+        }
+    };
+
+    template<>
+    struct __fmt_writer<void *> : __fmt_writer<const void *> {};
+
+    template<>
+    struct __fmt_writer<std::nullptr_t> : __fmt_writer<const void *> {};
+
+    /// @note: tree-like arguments (std::tree and anything shaped like it): a root() whose nodes have data()
+    ///     and a random access range of child nodes.
+    template<typename _ty>
+    concept __fmt_tree_node = requires(_ty const &_n) {
+        _n.data();
+        { _n.children() } -> std::ranges::random_access_range;
+    };
+
+    template<typename _ty>
+    concept __fmt_tree = requires(_ty const &_t) { { _t.root() } -> __fmt_tree_node; };
+
+    /// @note: ranges (containers, views) that are not strings and not trees.
+    template<typename _ty>
+    concept __fmt_range = std::ranges::input_range<_ty const> && !std::convertible_to<_ty const &, std::string_view>
+        && !__fmt_tree<_ty>;
+
+    /// @note: tuple-like arguments (std::tuple, std::pair) that are not ranges.
+    template<typename _ty>
+    concept __fmt_tuple = !__fmt_range<_ty> && requires { std::tuple_size<_ty>::value; };
+
+    /// @fn: checks the spec of a container: no presentation type (apart from the ones in _types), a
+    ///     precision is the maximum number of elements written.
+    constexpr const char *__fmt_check_container(__fmt_spec const &_s, const char *_types = "") {
+        if (_s._type == 0)
+            return nullptr;
+        for (; *_types; ++_types)
+            if (*_types == _s._type)
+                return nullptr;
+        return "invalid presentation type for a container";
+    }
+
+    /// @note: a std::byte is written as the number it holds.
+    template<>
+    struct __fmt_writer<std::byte> {
+        static constexpr const char *check(__fmt_spec const &_s) {
+            return __fmt_writer<unsigned char>::check(_s);
+        }
+        static void write(__fmt_buffer &_out, std::byte _v, __fmt_spec const &_s) {
+            __fmt_writer<unsigned char>::write(_out, (unsigned char) _v, _s);
+        }
+    };
+
+    /// @note: contiguous ranges of bytes, which the byte encodings apply to.
+    template<typename _ty>
+    concept __fmt_bytes = std::ranges::contiguous_range<_ty const> && std::ranges::sized_range<_ty const>
+        && sizeof(std::ranges::range_value_t<_ty>) == 1
+        && (std::same_as<std::ranges::range_value_t<_ty>, std::byte> || std::same_as<std::ranges::range_value_t<_ty>, unsigned char>);
+
+    /// @note: ranges are written as `[a, b, c]`, element by element straight into the output; a precision
+    ///     (`{:.100}`) caps the number of elements and ends the list with `...`. byte ranges (std::byte,
+    ///     unsigned char) can also be hex (`{:x}` / `{:X}`) or base64 (`{:b64}`) encoded as one payload.
+    template<__fmt_range _ty>
+    struct __fmt_writer<_ty> {
+        using _elem = __fmt_arg_t<std::ranges::range_reference_t<_ty const>>;
+
+        static constexpr const char *check(__fmt_spec const &_s) {
+            if (__fmt_bytes<_ty> && __fmt_is_encoding(_s._type))
+                return nullptr;
+            if (const char *err = __fmt_check_container(_s))
+                return err;
+            return __fmt_writer<_elem>::check(__fmt_spec {});
+        }
+        static void write(__fmt_buffer &_out, _ty const &_v, __fmt_spec const &_s) {
+            if constexpr (__fmt_bytes<_ty>)
+                if (__fmt_is_encoding(_s._type)) {
+                    std::size_t n = (std::size_t) std::ranges::size(_v);
+                    if (_s._prec >= 0 && (std::size_t) _s._prec < n)
+                        n = (std::size_t) _s._prec;
+                    __fmt_append_encoded(_out, (const unsigned char *) std::ranges::data(_v), n, _s._type);
+                    return;
+                }
+            std::size_t limit = _s._prec >= 0 ? (std::size_t) _s._prec : (std::size_t) -1, n = 0;
+            _out.push_back('[');
+            for (auto const &e : _v) {
+                if (n != 0)
+                    _out.append(", ", 2);
+                if (n++ == limit) {
+                    _out.append("...", 3);
+                    break;
+                }
+                __fmt_writer<_elem>::write(_out, e, __fmt_spec {});
+            }
+            _out.push_back(']');
+        }
+    };
+
+    /// @note: tuples and pairs are written as `(a, b)`.
+    template<__fmt_tuple _ty>
+    struct __fmt_writer<_ty> {
+        template<std::size_t _i>
+        using _elem = __fmt_arg_t<std::tuple_element_t<_i, _ty>>;
+
+        static constexpr const char *check(__fmt_spec const &_s) {
+            if (_s._prec >= 0)
+                return "precision not allowed for a tuple";
+            if (const char *err = __fmt_check_container(_s))
+                return err;
+            return [&]<std::size_t... _is>(std::index_sequence<_is...>) {
+                const char *err = nullptr;
+                ((err = err ? err : __fmt_writer<_elem<_is>>::check(__fmt_spec {})), ...);
+                return err;
+            }(std::make_index_sequence<std::tuple_size_v<_ty>> {});
+        }
+        static void write(__fmt_buffer &_out, _ty const &_v, __fmt_spec const &) {
+            _out.push_back('(');
+            [&]<std::size_t... _is>(std::index_sequence<_is...>) {
+                ((_out.append(", ", _is ? 2 : 0), __fmt_writer<_elem<_is>>::write(_out, std::get<_is>(_v), __fmt_spec {})), ...);
+            }(std::make_index_sequence<std::tuple_size_v<_ty>> {});
+            _out.push_back(')');
+        }
+    };
+
+    /// @note: an optional is written as its value (with the spec of the field), or `none`.
+    template<typename _ty>
+    struct __fmt_writer<std::optional<_ty>> {
+        static constexpr const char *check(__fmt_spec const &_s) {
+            return __fmt_writer<_ty>::check(_s);
+        }
+        static void write(__fmt_buffer &_out, std::optional<_ty> const &_v, __fmt_spec const &_s) {
+            if (_v)
+                __fmt_writer<_ty>::write(_out, *_v, _s);
+            else
+                _out.append("none", 4);
+        }
+    };
+
+    /// @note: per thread cache of the last timestamp's `YYYY-MM-DDTHH:MM:SS`, log lines come many to the
+    ///     second so most timestamps copy it and only write their sub-second digits.
+    struct __fmt_time_cache {
+        /// @field: second (since the epoch) the text is for.
+        std::int64_t _sec = std::numeric_limits<std::int64_t>::min();
+        char _text[19];
+    };
+
+    inline thread_local __fmt_time_cache __fmt_time_tls;
+
+    /// @fn: `YYYY-MM-DDTHH:MM:SS` (UTC) of a second since the epoch: the cached text when it is the same
+    ///     second, the seconds rewritten when it is the same minute, and a full conversion (days to a
+    ///     civil date, no gmtime and no locks) otherwise.
+    inline const char *__fmt_time_prefix(std::int64_t _sec) _GLIBCXX_NOEXCEPT {
+        __fmt_time_cache &c = __fmt_time_tls;
+        if (c._sec == _sec)
+            return c._text;
+        auto floor_div = [](std::int64_t _a, std::int64_t _b) { return _a / _b - (_a % _b < 0); };
+        std::int64_t minute = floor_div(_sec, 60);
+        bool same_minute = c._sec != std::numeric_limits<std::int64_t>::min() && floor_div(c._sec, 60) == minute;
+        c._sec = _sec;
+        __fmt_write_dec_fixed<2>(c._text + 17, (std::uint32_t) (_sec - minute * 60));
+        if (same_minute)
+            return c._text;
+
+        std::int64_t z = floor_div(_sec, 86400), day_sec = _sec - z * 86400;
+        z += 719468;
+        std::int64_t era = floor_div(z, 146097), doe = z - era * 146097;
+        std::int64_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+        std::int64_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100), mp = (5 * doy + 2) / 153;
+        std::int64_t day = doy - (153 * mp + 2) / 5 + 1, month = mp < 10 ? mp + 3 : mp - 9;
+        std::int64_t year = yoe + era * 400 + (month <= 2);
+
+        __fmt_write_dec_fixed<4>(c._text, (std::uint32_t) (year % 10000));
+        __fmt_write_dec_fixed<2>(c._text + 5, (std::uint32_t) month);
+        __fmt_write_dec_fixed<2>(c._text + 8, (std::uint32_t) day);
+        __fmt_write_dec_fixed<2>(c._text + 11, (std::uint32_t) (day_sec / 3600));
+        __fmt_write_dec_fixed<2>(c._text + 14, (std::uint32_t) (day_sec / 60 % 60));
+        c._text[4] = c._text[7] = '-', c._text[10] = 'T', c._text[13] = c._text[16] = ':';
+        return c._text;
+    }
+
+    /// @note: system clock time points are written as ISO-8601 UTC timestamps, `2024-09-05T12:34:56.789012Z`
+    ///     (years 0000 to 9999); the sub-second digits follow the clock's resolution (none for seconds, 3
+    ///     for milliseconds, 6 for microseconds, 9 below that) or the precision (`{:.3}`, at most 9).
+    template<typename _dur>
+    struct __fmt_writer<std::chrono::time_point<std::chrono::system_clock, _dur>> {
+        using _tp = std::chrono::time_point<std::chrono::system_clock, _dur>;
+
+        static constexpr int __digits = _dur::period::den == 1 ? 0 : _dur::period::den <= 1000 ? 3
+            : _dur::period::den <= 1000000 ? 6 : 9;
+
+        static constexpr int digits(__fmt_spec const &_s) _GLIBCXX_NOEXCEPT {
+            return _s._prec >= 0 ? std::min(_s._prec, 9) : __digits;
+        }
+        static constexpr const char *check(__fmt_spec const &_s) {
+            return _s._type == 0 ? nullptr : "invalid presentation type for a time point";
+        }
+        static void write(__fmt_buffer &_out, _tp const &_v, __fmt_spec const &_s) {
+            auto sec = std::chrono::floor<std::chrono::seconds>(_v);
+            std::uint32_t ns = (std::uint32_t) std::chrono::duration_cast<std::chrono::nanoseconds>(_v - sec).count();
+            int n = digits(_s);
+
+            char local[32];
+            char *p = _out.try_reserve(32);
+            char *q = p ? p : local;
+            std::memcpy(q, __fmt_time_prefix((std::int64_t) sec.time_since_epoch().count()), 19);
+            q += 19;
+            if (n != 0) {
+                *q++ = '.';
+                std::uint32_t frac = n == 9 ? ns : ns / (std::uint32_t) __fmt_pow10[9 - n];
+                for (char *d = q + n; d != q; frac /= 10)
+                    *--d = (char) ('0' + frac % 10);
+                q += n;
+            }
+            *q++ = 'Z';
+            if (p)
+                _out.commit((std::size_t) (q - p));
+            else
+                _out.append(local, (std::size_t) (q - local));
+        }
+        static constexpr std::size_t size(_tp const &, __fmt_spec const &_s) _GLIBCXX_NOEXCEPT {
+            int n = digits(_s);
+            return 20 + (n ? (std::size_t) n + 1 : 0);
+        }
+    };
+
+    /// @note: trees are written bracketed, `root[child, child[grandchild]]`, or indented with `{:i}` (one
+    ///     node per line, two spaces per level); a precision caps the number of nodes written. the walk
+    ///     is iterative (pre-order, one stack entry per level) and never copies a node.
+    template<__fmt_tree _ty>
+    struct __fmt_writer<_ty> {
+        using _node = std::remove_cvref_t<decltype(std::declval<_ty const &>().root())>;
+        using _data = __fmt_arg_t<decltype(std::declval<_node const &>().data())>;
+
+        static constexpr const char *check(__fmt_spec const &_s) {
+            if (const char *err = __fmt_check_container(_s, "i"))
+                return err;
+            return __fmt_writer<_data>::check(__fmt_spec {});
+        }
+        static void write(__fmt_buffer &_out, _ty const &_v, __fmt_spec const &_s) {
+            struct _entry {
+                _node const *node;
+                std::size_t next;
+            };
+            bool indent = _s._type == 'i';
+            std::size_t limit = _s._prec >= 0 ? (std::size_t) _s._prec : (std::size_t) -1, n = 0;
+            std::vector<_entry> stack;
+            _node const &root = _v.root();
+            if (limit == 0) {
+                _out.append("...", 3);
+                return;
+            }
+            __fmt_writer<_data>::write(_out, root.data(), __fmt_spec {});
+            ++n;
+            stack.push_back({ &root, 0 });
+            while (!stack.empty()) {
+                _entry &top = stack.back();
+                auto const &children = top.node->children();
+                if (top.next == (std::size_t) std::ranges::size(children)) {
+                    if (!indent && top.next != 0)
+                        _out.push_back(']');
+                    stack.pop_back();
+                    continue;
+                }
+
+                /// separator, then either the next child or the truncation mark (closing every open list).
+                if (indent) {
+                    _out.push_back('\n');
+                    for (std::size_t d = 0; d < stack.size(); ++d)
+                        _out.append("  ", 2);
+                } else
+                    _out.append(top.next == 0 ? "[" : ", ", top.next == 0 ? 1 : 2);
+                if (n++ == limit) {
+                    _out.append("...", 3);
+                    if (!indent)
+                        for (std::size_t d = 0; d < stack.size(); ++d)
+                            _out.push_back(']');
+                    return;
+                }
+                _node const &child = std::ranges::begin(children)[top.next++];
+                __fmt_writer<_data>::write(_out, child.data(), __fmt_spec {});
+                stack.push_back({ &child, 0 });
+            }
+        }
+    };
+
+    /// @note: one function per compile-time error, none of them constexpr: the compiler cannot show a message
+    ///     string in its diagnostic, but it does name the non-constexpr function that was called.
+    inline void __fmt_error_unmatched_closing_brace() {}
+    inline void __fmt_error_missing_closing_brace() {}
+    inline void __fmt_error_field_must_be_empty_or_start_with_colon() {}
+    inline void __fmt_error_fewer_fields_than_arguments() {}
+    inline void __fmt_error_more_fields_than_arguments() {}
+    inline void __fmt_error_invalid_field_spec() {}
+    inline void __fmt_error_fill_must_be_ascii() {}
+    inline void __fmt_error_width_too_large() {}
+    inline void __fmt_error_missing_precision_after_dot() {}
+    inline void __fmt_error_precision_too_large() {}
+    inline void __fmt_error_unknown_presentation_type() {}
+    inline void __fmt_error_zero_padding_only_for_numbers() {}
+    inline void __fmt_error_precision_not_allowed_for_integer() {}
+    inline void __fmt_error_precision_not_allowed_for_bool() {}
+    inline void __fmt_error_precision_not_allowed_for_character() {}
+    inline void __fmt_error_precision_not_allowed_for_pointer() {}
+    inline void __fmt_error_precision_not_allowed_for_tuple() {}
+    inline void __fmt_error_invalid_type_for_integer() {}
+    inline void __fmt_error_invalid_type_for_bool() {}
+    inline void __fmt_error_invalid_type_for_floating_point() {}
+    inline void __fmt_error_invalid_type_for_string() {}
+    inline void __fmt_error_invalid_type_for_pointer() {}
+    inline void __fmt_error_invalid_type_for_container() {}
+    inline void __fmt_error_invalid_type_for_time_point() {}
+    inline void __fmt_error_lazy_format_takes_no_spec() {}
+    inline void __fmt_error_width_and_alignment_not_allowed_in_scan() {}
+    inline void __fmt_error_precision_not_allowed_when_scanning_integer() {}
+    inline void __fmt_error_precision_not_allowed_when_scanning_floating_point() {}
+    inline void __fmt_error_invalid_scan_spec_for_bool() {}
+    inline void __fmt_error_invalid_scan_spec_for_char() {}
+    inline void __fmt_error_invalid_format_string() {}
+
+    /// @note: the messages the parse and check functions of format.h and scan.h return, with their function.
+    struct __fmt_error_entry {
+        const char *_msg;
+        void (*_report)();
+    };
+
+    inline constexpr __fmt_error_entry __fmt_errors[] = {
+        { "unmatched '}' in format string", &__fmt_error_unmatched_closing_brace },
+        { "missing '}' in replacement field", &__fmt_error_missing_closing_brace },
+        { "a replacement field must be {} or {:spec}", &__fmt_error_field_must_be_empty_or_start_with_colon },
+        { "fewer replacement fields than arguments", &__fmt_error_fewer_fields_than_arguments },
+        { "more replacement fields than arguments", &__fmt_error_more_fields_than_arguments },
+        { "invalid replacement field spec", &__fmt_error_invalid_field_spec },
+        { "fill must be an ASCII character", &__fmt_error_fill_must_be_ascii },
+        { "width is too large", &__fmt_error_width_too_large },
+        { "missing precision after '.'", &__fmt_error_missing_precision_after_dot },
+        { "precision is too large", &__fmt_error_precision_too_large },
+        { "unknown presentation type", &__fmt_error_unknown_presentation_type },
+        { "'0' padding is only allowed for numbers", &__fmt_error_zero_padding_only_for_numbers },
+        { "precision not allowed for an integer", &__fmt_error_precision_not_allowed_for_integer },
+        { "precision not allowed for a bool", &__fmt_error_precision_not_allowed_for_bool },
+        { "precision not allowed for a character", &__fmt_error_precision_not_allowed_for_character },
+        { "precision not allowed for a pointer", &__fmt_error_precision_not_allowed_for_pointer },
+        { "precision not allowed for a tuple", &__fmt_error_precision_not_allowed_for_tuple },
+        { "invalid presentation type for an integer", &__fmt_error_invalid_type_for_integer },
+        { "invalid presentation type for a bool", &__fmt_error_invalid_type_for_bool },
+        { "invalid presentation type for a floating point number", &__fmt_error_invalid_type_for_floating_point },
+        { "invalid presentation type for a string", &__fmt_error_invalid_type_for_string },
+        { "invalid presentation type for a pointer", &__fmt_error_invalid_type_for_pointer },
+        { "invalid presentation type for a container", &__fmt_error_invalid_type_for_container },
+        { "invalid presentation type for a time point", &__fmt_error_invalid_type_for_time_point },
+        { "a lazy format takes no spec", &__fmt_error_lazy_format_takes_no_spec },
+        { "width and alignment are not allowed in a scan pattern", &__fmt_error_width_and_alignment_not_allowed_in_scan },
+        { "precision is not allowed when scanning an integer", &__fmt_error_precision_not_allowed_when_scanning_integer },
+        { "precision is not allowed when scanning a floating point number", &__fmt_error_precision_not_allowed_when_scanning_floating_point },
+        { "invalid spec for a bool", &__fmt_error_invalid_scan_spec_for_bool },
+        { "invalid spec for a char", &__fmt_error_invalid_scan_spec_for_char },
+    };
+
+    /// @fn: called with the error message when a format string is rejected during constant evaluation; calls
+    ///     the named function of that message (or __fmt_error_invalid_format_string for one that is not
+    ///     listed, e.g. from a user's writer), which ends the evaluation with a diagnostic naming the error.
+    constexpr void __fmt_compile_error(const char *_err) {
+        for (__fmt_error_entry const &e : __fmt_errors) {
+            std::size_t i = 0;
+            while (e._msg[i] && e._msg[i] == _err[i])
+                ++i;
+            if (e._msg[i] == _err[i])
+                return e._report();
+        }
+        if (_err)
+            __fmt_error_invalid_format_string();
+    }
+
+    /// @fn: finds the first _a or _b in [_first, _last) (or _last), comparing 32 / 16 bytes at a time where
+    ///     AVX2 / SSE2 are available; literal text between the hits is then copied with plain memcpy.
+    inline const char *__fmt_find2(const char *_first, const char *_last, char _a, char _b) _GLIBCXX_NOEXCEPT {
+#if defined(__AVX2__)
+        const __m256i a32 = _mm256_set1_epi8(_a), b32 = _mm256_set1_epi8(_b);
+        for (; _last - _first >= 32; _first += 32) {
+            __m256i v = _mm256_loadu_si256((const __m256i *) _first);
+            unsigned mask = (unsigned) _mm256_movemask_epi8(_mm256_or_si256(_mm256_cmpeq_epi8(v, a32), _mm256_cmpeq_epi8(v, b32)));
+            if (mask != 0)
+                return _first + __builtin_ctz(mask);
+        }
+#endif
+#if defined(__SSE2__)
+        const __m128i a16 = _mm_set1_epi8(_a), b16 = _mm_set1_epi8(_b);
+        for (; _last - _first >= 16; _first += 16) {
+            __m128i v = _mm_loadu_si128((const __m128i *) _first);
+            unsigned mask = (unsigned) _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(v, a16), _mm_cmpeq_epi8(v, b16)));
+            if (mask != 0)
+                return _first + __builtin_ctz(mask);
+        }
+#endif
+        for (; _first != _last; ++_first)
+            if (*_first == _a || *_first == _b)
+                return _first;
+        return _last;
+    }
+
+    /// @fn: parses a replacement field spec (after the ':') up to the closing brace.
+    template<typename _ch>
+    constexpr const char *__fmt_parse_spec(std::basic_string_view<_ch> _s, std::size_t &_pos, __fmt_spec &_spec) {
+        auto align = [](_ch c) { return c == '<' || c == '>' || c == '^'; };
+        if (_pos + 1 < _s.size() && align(_s[_pos + 1]) && _s[_pos] != '{' && _s[_pos] != '}') {
+            if ((std::make_unsigned_t<_ch>) _s[_pos] > 0x7f)
+                return "fill must be an ASCII character";
+            _spec._fill = (char) _s[_pos];
+            _spec._align = (char) _s[_pos + 1];
+            _pos += 2;
+        } else if (_pos < _s.size() && align(_s[_pos]))
+            _spec._align = (char) _s[_pos++];
+        if (_pos < _s.size() && _s[_pos] == '0') {
+            _spec._zero = true;
+            ++_pos;
+        }
+        for (; _pos < _s.size() && _s[_pos] >= '0' && _s[_pos] <= '9'; ++_pos)
+            if ((_spec._width = _spec._width * 10 + (int) (_s[_pos] - '0')) > 0xffff)
+                return "width is too large";
+        if (_pos < _s.size() && _s[_pos] == '.') {
+            if (++_pos >= _s.size() || _s[_pos] < '0' || _s[_pos] > '9')
+                return "missing precision after '.'";
+            for (_spec._prec = 0; _pos < _s.size() && _s[_pos] >= '0' && _s[_pos] <= '9'; ++_pos)
+                if ((_spec._prec = _spec._prec * 10 + (int) (_s[_pos] - '0')) > 0xffff)
+                    return "precision is too large";
+        }
+        if (_pos < _s.size() && _s[_pos] != '}') {
+            auto alpha = [](_ch c) { return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z'); };
+            if (!alpha(_s[_pos]))
+                return "invalid replacement field spec";
+
+            /// a single letter is the type itself, longer names are looked up.
+            std::size_t first = _pos;
+            while (++_pos < _s.size() && (alpha(_s[_pos]) || (_s[_pos] >= '0' && _s[_pos] <= '9')));
+            if (_pos - first == 1)
+                _spec._type = (char) _s[first];
+            else {
+                for (__fmt_named_type const &t : __fmt_named_types) {
+                    std::size_t i = 0;
+                    while (t._name[i] && first + i < _pos && _s[first + i] == (_ch) t._name[i])
+                        ++i;
+                    if (!t._name[i] && first + i == _pos)
+                        _spec._type = t._code;
+                }
+                if (_spec._type == 0)
+                    return "unknown presentation type";
+            }
+        }
+        if (_pos >= _s.size() || _s[_pos] != '}')
+            return "missing '}' in replacement field";
+        return nullptr;
+    }
+
+    /// @fn: splits a format string into _n + 1 literal runs and _n replacement field specs.
+    template<typename _ch>
+    constexpr const char *__fmt_parse(std::basic_string_view<_ch> _s, __fmt_literal *_lits, __fmt_spec *_specs, std::size_t _n) {
+        std::size_t pos = 0;
+        for (std::size_t i = 0;; ++i) {
+            __fmt_literal &lit = _lits[i];
+            lit._off = pos;
+            while (pos < _s.size()) {
+                if constexpr (std::is_same_v<_ch, char>) {
+                    /// at run time (compile_format), jump over literal text in vector-sized steps.
+                    if (!std::is_constant_evaluated()) {
+                        pos = (std::size_t) (__fmt_find2(_s.data() + pos, _s.data() + _s.size(), '{', '}') - _s.data());
+                        if (pos == _s.size())
+                            break;
+                    }
+                }
+                if (_s[pos] != '{' && _s[pos] != '}') {
+                    ++pos;
+                    continue;
+                }
+                if (pos + 1 < _s.size() && _s[pos + 1] == _s[pos]) {
+                    ++lit._esc;
+                    pos += 2;
+                    continue;
+                }
+                if (_s[pos] == '}')
+                    return "unmatched '}' in format string";
+                break;
+            }
+            lit._len = pos - lit._off;
+            if (pos == _s.size())
+                return i == _n ? nullptr : "fewer replacement fields than arguments";
+            if (i == _n)
+                return "more replacement fields than arguments";
+
+            /// skip the '{'; a field is either empty or a ':' and its spec, anything else (an argument index
+            ///     or a name) is rejected rather than read as a spec.
+            if (++pos < _s.size() && _s[pos] == ':')
+                ++pos;
+            else if (pos < _s.size() && _s[pos] != '}')
+                return "a replacement field must be {} or {:spec}";
+            if (const char *err = __fmt_parse_spec(_s, pos, _specs[i]))
+                return err;
+            ++pos;
+        }
+    }
+
+    /// @note: arguments that are padded with zeros by `{:0N}`, and aligned to the right by default.
+    template<typename _ty>
+    concept __fmt_numeric = __fmt_int<_ty> || std::floating_point<_ty>;
+
+    /// @fn: checks one field spec against the writer of its argument.
+    template<typename _ty>
+    constexpr const char *__fmt_check_field(__fmt_spec const &_s) {
+        if (_s._zero && !__fmt_numeric<_ty>)
+            return "'0' padding is only allowed for numbers";
+        return __fmt_writer<_ty>::check(_s);
+    }
+
+    /// @fn: checks every field spec against the writer of its argument, returns the first error (or nullptr).
+    template<typename... pargs_t>
+    constexpr const char *__fmt_check(__fmt_spec const *_specs) {
+        const char *err = nullptr;
+        std::size_t i = 0;
+        ((err = err ? err : __fmt_check_field<pargs_t>(_specs[i]), ++i), ...);
+        return err;
+    }
+
+    /// @note: format string checked and split up at compile time against the argument types.
+    template<typename _ch, typename... pargs_t>
+    struct __fmt_basic_string {
+        /// @field: the format string itself.
+        std::basic_string_view<_ch> _str;
+
+        /// @field: literal runs (one more than there are arguments) and the spec of every field.
+        std::array<__fmt_literal, sizeof...(pargs_t) + 1> _lits {};
+        std::array<__fmt_spec, sizeof...(pargs_t)> _specs {};
+
+        template<typename _s> requires std::convertible_to<_s const &, std::basic_string_view<_ch>>
+        consteval __fmt_basic_string(_s const &_format) : _str(_format) {
+            if (const char *err = __fmt_parse(_str, _lits.data(), _specs.data(), sizeof...(pargs_t)))
+                __fmt_compile_error(err);
+            if (const char *err = __fmt_check<pargs_t...>(_specs.data()))
+                __fmt_compile_error(err);
+        }
+    };
+
+    template<typename... pargs_t>
+    using __fmt_string = __fmt_basic_string<char, __fmt_arg_t<pargs_t>...>;
+
+    template<typename... pargs_t>
+    using __fmt_wstring = __fmt_basic_string<wchar_t, __fmt_arg_t<pargs_t>...>;
+
+    /// @fn: writes the _i'th literal run, collapsing doubled braces if it has any; the literals of a wide
+    ///     format string are transcoded, the engine always produces UTF-8.
+    template<typename _prog>
+    inline void __fmt_put_literal(__fmt_buffer &_out, _prog const &_f, std::size_t _i) {
+        using _ch = typename std::remove_cvref_t<decltype(_f._str)>::value_type;
+        __fmt_literal const &lit = _f._lits[_i];
+        if constexpr (__fmt_wide_char<_ch>) {
+            const _ch *s = _f._str.data() + lit._off, *end = s + lit._len;
+            if (lit._esc)
+                for (const _ch *p = s; p != end; ++p)
+                    if (*p == '{' || *p == '}') {
+                        __fmt_append_utf8(_out, s, p + 1);
+                        s = ++p + 1;
+                    }
+            __fmt_append_utf8(_out, s, end);
+        } else {
+            const char *s = _f._str.data() + lit._off;
+            if (!lit._esc) {
+                _out.append(s, lit._len);
+                return;
+            }
+
+            /// copy the clean text between doubled braces in bulk, and one brace of every pair.
+            for (const char *end = s + lit._len; s < end; s += 2) {
+                const char *brace = __fmt_find2(s, end, '{', '}');
+                _out.append(s, (std::size_t) (brace - s));
+                if (brace == end)
+                    break;
+                _out.push_back(*brace);
+                s = brace;
+            }
+        }
+    }
+
+    /// @fn: length one argument formats to; writers without a size() are formatted into a counting buffer.
+    template<typename _ty>
+    inline std::size_t __fmt_size_of(_ty const &_v, __fmt_spec const &_s) {
+        if constexpr (requires { { __fmt_writer<_ty>::size(_v, _s) } -> std::convertible_to<std::size_t>; })
+            return __fmt_writer<_ty>::size(_v, _s);
+        else {
+            __fmt_counting_buffer buf;
+            __fmt_writer<_ty>::write(buf, _v, _s);
+            return buf.count();
+        }
+    }
+
+    /// @fn: appends _n copies of a fill character, memset in place (in chunks when the buffer has no room).
+    inline void __fmt_append_fill(__fmt_buffer &_out, char _c, std::size_t _n) {
+        if (char *p = _out.try_reserve(_n)) {
+            std::memset(p, _c, _n);
+            _out.commit(_n);
+            return;
+        }
+        char chunk[64];
+        std::memset(chunk, _c, sizeof(chunk));
+        for (; _n > sizeof(chunk); _n -= sizeof(chunk))
+            _out.append(chunk, sizeof(chunk));
+        _out.append(chunk, _n);
+    }
+
+    /// @fn: fills _n bytes with _c in fixed 16-byte stores (no call for short fills); it writes up to 15
+    ///     bytes past _n, callers have the room (from try_reserve_slack()).
+    inline void __fmt_fill_over(char *_p, char _c, std::size_t _n) _GLIBCXX_NOEXCEPT {
+        char pattern[16];
+        std::memset(pattern, _c, sizeof(pattern));
+        for (std::size_t i = 0; i < _n; i += 16)
+            std::memcpy(_p + i, pattern, 16);
+    }
+
+    /// @fn: writes a field of _len characters (its exact size) padded out to the width of the spec: the
+    ///     padding around the value is filled in bulk (16-byte stores in place, memset chunks otherwise), so
+    ///     padding costs no per-character work. zero padding goes between the sign and the digits (infinity
+    ///     and NaN, in either case, are padded with spaces).
+    template<typename _fn>
+    inline void __fmt_write_padded(__fmt_buffer &_out, __fmt_spec const &_s, std::size_t _len, bool _numeric, _fn &&_write) {
+        std::size_t width = (std::size_t) _s._width, pad = width - _len;
+        bool zero = _s._zero && _s._align == 0;
+        char align = _s._align ? _s._align : _numeric ? '>' : '<';
+        std::size_t before = zero || align == '>' ? pad : align == '^' ? pad / 2 : 0;
+
+        /// with the room in place (and the slack writers reserve beyond their exact size) the output stays
+        /// contiguous: fill, write the value after it, fill again.
+        if (char *p = _out.try_reserve_slack(width + 64)) {
+            __fmt_fill_over(p, zero ? '0' : _s._fill, before);
+            _out.commit(before);
+            _write(_out);
+            if (zero) {
+                char *v = p + pad;
+                std::size_t sign = *v == '-' || *v == '+' || *v == ' ';
+                char first = sign < _len ? (char) (v[sign] | 0x20) : '0';
+                if (first == 'i' || first == 'n')
+                    std::memset(p, ' ', pad);
+                else if (sign)
+                    std::swap(p[0], *v);
+            }
+            __fmt_fill_over(p + before + _len, _s._fill, pad - before);
+            _out.commit(pad - before);
+            return;
+        }
+
+        if (zero) {
+            __fmt_memory_buffer<64> tmp;
+            _write(tmp);
+            const char *v = tmp.data();
+            std::size_t sign = _len && (*v == '-' || *v == '+' || *v == ' ');
+            char first = sign < _len ? (char) (v[sign] | 0x20) : '0';
+            if (first == 'i' || first == 'n')
+                __fmt_append_fill(_out, ' ', pad), sign = 0;
+            else {
+                _out.append(v, sign);
+                __fmt_append_fill(_out, '0', pad);
+            }
+            _out.append(v + sign, _len - sign);
+            return;
+        }
+        __fmt_append_fill(_out, _s._fill, before);
+        _write(_out);
+        __fmt_append_fill(_out, _s._fill, pad - before);
+    }
+
+    /// @fn: writes one replacement field: straight through its writer, or padded to a width (measured with
+    ///     the writer's size(), no trial formatting for the types that have one).
+    template<typename _ty>
+    inline void __fmt_write_field(__fmt_buffer &_out, _ty const &_v, __fmt_spec const &_s) {
+        if (_s._width == 0) [[likely]] {
+            __fmt_writer<_ty>::write(_out, _v, _s);
+            return;
+        }
+        std::size_t len = __fmt_size_of(_v, _s);
+        if (len >= (std::size_t) _s._width) {
+            __fmt_writer<_ty>::write(_out, _v, _s);
+            return;
+        }
+        __fmt_write_padded(_out, _s, len, __fmt_numeric<_ty>, [&](__fmt_buffer &_to) { __fmt_writer<_ty>::write(_to, _v, _s); });
+    }
+
+    /// @fn: length one replacement field formats to, padding included.
+    template<typename _ty>
+    inline std::size_t __fmt_field_size(_ty const &_v, __fmt_spec const &_s) {
+        std::size_t len = __fmt_size_of(_v, _s);
+        return len < (std::size_t) _s._width ? (std::size_t) _s._width : len;
+    }
+
+    /// @fn: the formatting engine, one pass over a pre-split format string (compile time checked or
+    ///     compiled at run time, both expose _str, _lits and _specs) with no parsing.
+    template<typename... pargs_t, typename _prog>
+    inline void __fmt_format_to(__fmt_buffer &_out, _prog const &_f, pargs_t const &... _args) {
+        [&]<std::size_t... _is>(std::index_sequence<_is...>) {
+            ((__fmt_put_literal(_out, _f, _is), __fmt_write_field<pargs_t>(_out, _args, _f._specs[_is])), ...);
+        }(std::index_sequence_for<pargs_t...> {});
+        __fmt_put_literal(_out, _f, sizeof...(pargs_t));
+    }
+
+    /// @fn: exact output length of a pre-split format string: literal lengths (less the collapsed braces)
+    ///     plus the size of every argument, without producing any output.
+    template<typename... pargs_t, typename _prog>
+    inline std::size_t __fmt_formatted_size(_prog const &_f, pargs_t const &... _args) {
+        std::size_t n = 0;
+        for (__fmt_literal const &lit : _f._lits)
+            n += lit._len - lit._esc;
+        [&]<std::size_t... _is>(std::index_sequence<_is...>) {
+            ((n += __fmt_field_size<pargs_t>(_args, _f._specs[_is])), ...);
+        }(std::index_sequence_for<pargs_t...> {});
+        return n;
+    }
+
+    /// @note: the `{}` entry points whose names C++20's <format> also defines live in std::cxx, so both
+    ///     headers can be included together and std::cxx::format never competes with std::format.
+    namespace cxx {
+        /// @fn: formats a string with `{}` replacement fields (the format string is checked and split at compile time).
+        /// @tparam: ...pargs_t argument types, every one needs a writer.
+        /// @param: _format the format string, `{}` or `{:type}` fields and `{{` / `}}` for literal braces.
+        /// @param: _args the arguments, one per replacement field.
+        template<typename... pargs_t>
+        _GLIBCXX_NODISCARD
+        inline std::string
+        format(__fmt_string<pargs_t...> _format, pargs_t &&... _args) {
+            __fmt_memory_buffer<> buf;
+            __fmt_format_to<__fmt_arg_t<pargs_t>...>(buf, _format, _args...);
+            return std::string(buf.data(), buf.size());
+        }
+
+        /// @fn: formats a wide string; the output is produced as UTF-8 by the same engine and transcoded to
+        ///     wchar_t once, at the end (no swprintf, no locale).
+        template<typename... pargs_t>
+        _GLIBCXX_NODISCARD
+        inline std::wstring
+        format(__fmt_wstring<pargs_t...> _format, pargs_t &&... _args) {
+            __fmt_memory_buffer<> buf;
+            __fmt_format_to<__fmt_arg_t<pargs_t>...>(buf, _format, _args...);
+            std::wstring out(buf.size(), L'\0');
+            out.resize((std::size_t) (__utf8_decode(buf.data(), buf.data() + buf.size(), out.data()) - out.data()));
+            return out;
+        }
+
+        /// @fn: formats a string whose storage comes from _alloc (an arena, a pool); the output is built on
+        ///     the stack and only the result string allocates, nothing touches the global heap.
+        /// @param: _alloc the allocator of the result.
+        template<typename _alloc, typename... pargs_t>
+        _GLIBCXX_NODISCARD
+        inline std::basic_string<char, std::char_traits<char>, _alloc>
+        format(std::allocator_arg_t, _alloc const &_a, __fmt_string<pargs_t...> _format, pargs_t &&... _args) {
+            std::basic_string<char, std::char_traits<char>, _alloc> out(_a);
+            __fmt_string_buffer<decltype(out)> buf(out);
+            __fmt_format_to<__fmt_arg_t<pargs_t>...>(buf, _format, _args...);
+            buf.finish();
+            return out;
+        }
+
+        /// @fn: formats a string allocated from a memory resource (request scoped formatting is then
+        ///     released with the resource).
+        /// @param: _mr the memory resource of the result.
+        template<typename... pargs_t>
+        _GLIBCXX_NODISCARD
+        inline std::pmr::string
+        format(std::pmr::memory_resource *_mr, __fmt_string<pargs_t...> _format, pargs_t &&... _args) {
+            return cxx::format(std::allocator_arg, std::pmr::polymorphic_allocator<char>(_mr), _format,
+                std::forward<pargs_t>(_args)...);
+        }
+    }
+
+    /// @fn: formats into the calling thread's reusable buffer; once that has grown to the largest output,
+    ///     formatting no longer allocates at all (outputs over __fmt_reusable_keep excepted, that storage
+    ///     is given back on the next use).
+    /// @return: a view of the output, valid until the thread's buffer is used again: the next format_view,
+    ///     cxx::format_to(sink), format_rows or format_rows_to on this thread.
+    template<typename... pargs_t>
+    _GLIBCXX_NODISCARD
+    inline std::string_view
+    format_view(__fmt_string<pargs_t...> _format, pargs_t &&... _args) {
+        __fmt_tls_guard guard;
+        __fmt_format_to<__fmt_arg_t<pargs_t>...>(guard._buf, _format, _args...);
+        return { guard._buf.data(), guard._buf.size() };
+    }
+
+    /// @note: caller-provided sinks, anything with append(const char *, size_t) (std::string, a log writer).
+    template<typename _ty>
+    concept __fmt_sink = requires(_ty &_s, const char *_p, std::size_t _n) { _s.append(_p, _n); };
+
+    namespace cxx {
+        /// @fn: formats through the thread's reusable buffer and hands the output to a sink in one append().
+        /// @param: _sink the sink that receives the output.
+        /// @return: the number of characters appended.
+        template<__fmt_sink _sink_t, typename... pargs_t>
+        inline std::size_t
+        format_to(_sink_t &_sink, __fmt_string<pargs_t...> _format, pargs_t &&... _args) {
+            __fmt_tls_guard guard;
+            __fmt_format_to<__fmt_arg_t<pargs_t>...>(guard._buf, _format, _args...);
+            _sink.append(guard._buf.data(), guard._buf.size());
+            return guard._buf.size();
+        }
+
+        /// @fn: computes the exact length cxx::format would produce, from digit counts, string lengths and
+        ///     literal lengths, without formatting; callers can reserve once in their own buffers.
+        template<typename... pargs_t>
+        _GLIBCXX_NODISCARD
+        inline std::size_t
+        formatted_size(__fmt_string<pargs_t...> _format, pargs_t &&... _args) {
+            return __fmt_formatted_size<__fmt_arg_t<pargs_t>...>(_format, _args...);
+        }
+
+        /// @note: result of format_to_n, the iterator past the last written character and the full length
+        ///     the output would have had.
+        template<typename _out_it>
+        struct format_to_n_result {
+            _out_it out;
+            std::iter_difference_t<_out_it> size;
+        };
+
+        /// @fn: formats straight into an output iterator (a char pointer is written to directly).
+        /// @param: _out where to write to, it has to have room for the whole output.
+        /// @return: the iterator past the last written character.
+        template<typename _out_it, typename... pargs_t> requires std::output_iterator<_out_it, const char &>
+        inline _out_it
+        format_to(_out_it _out, __fmt_string<pargs_t...> _format, pargs_t &&... _args) {
+            if constexpr (std::is_same_v<_out_it, char *>) {
+                __fmt_fixed_buffer buf(_out);
+                __fmt_format_to<__fmt_arg_t<pargs_t>...>(buf, _format, _args...);
+                return _out + buf.size();
+            } else {
+                __fmt_iterator_buffer<_out_it> buf(std::move(_out));
+                __fmt_format_to<__fmt_arg_t<pargs_t>...>(buf, _format, _args...);
+                return buf.out();
+            }
+        }
+
+        /// @fn: formats into an output iterator, writing at most _n characters.
+        /// @return: the iterator past the last written character, and the length of the untruncated output.
+        template<typename _out_it, typename... pargs_t> requires std::output_iterator<_out_it, const char &>
+        inline format_to_n_result<_out_it>
+        format_to_n(_out_it _out, std::iter_difference_t<_out_it> _n, __fmt_string<pargs_t...> _format, pargs_t &&... _args) {
+            std::size_t n = _n > 0 ? (std::size_t) _n : 0;
+            if constexpr (std::is_same_v<_out_it, char *>) {
+                __fmt_fixed_buffer buf(_out, n);
+                __fmt_format_to<__fmt_arg_t<pargs_t>...>(buf, _format, _args...);
+                return { _out + buf.size(), (std::iter_difference_t<_out_it>) buf.count() };
+            } else {
+                __fmt_iterator_buffer<_out_it> buf(std::move(_out), n);
+                __fmt_format_to<__fmt_arg_t<pargs_t>...>(buf, _format, _args...);
+                auto size = buf.count();
+                return { buf.out(), (std::iter_difference_t<_out_it>) size };
+            }
+        }
+    }
+
+    /// @note: format string that is only known at run time (configuration) but reused many times; it is
+    ///     parsed and checked against the argument types once, when it is compiled, and every call after
+    ///     that is the same single pass the compile time checked format() makes.
+    template<typename... pargs_t>
+    class compiled_format {
+    private:
+        /// @field: the format string (owned), its literal runs and the spec of every field.
+        std::string _str;
+        std::array<__fmt_literal, sizeof...(pargs_t) + 1> _lits {};
+        std::array<__fmt_spec, sizeof...(pargs_t)> _specs {};
+
+        template<typename... _ts, typename _prog>
+        friend void __fmt_format_to(__fmt_buffer &, _prog const &, _ts const &...);
+
+        template<typename _prog>
+        friend void __fmt_put_literal(__fmt_buffer &, _prog const &, std::size_t);
+
+        template<typename... _ts, typename _prog>
+        friend std::size_t __fmt_formatted_size(_prog const &, _ts const &...);
+
+        template<typename... _ts>
+        friend void __fmt_format_rows(__fmt_buffer &, compiled_format<_ts...> const &, std::span<_ts const>...);
+
+    public:
+        /// @note: compiles a format string, throws std::invalid_argument when it does not fit the arguments.
+        explicit compiled_format(std::string_view _format) : _str(_format) {
+            const char *err = __fmt_parse(std::string_view(_str), _lits.data(), _specs.data(), sizeof...(pargs_t));
+            if (!err)
+                err = __fmt_check<pargs_t...>(_specs.data());
+            if (err)
+                throw std::invalid_argument(err);
+        }
+
+        /// @fn: getter for the format string.
+        _GLIBCXX_NODISCARD std::string_view str() const _GLIBCXX_NOEXCEPT { return _str; }
+
+        /// @fn: formats a string.
+        _GLIBCXX_NODISCARD
+        std::string format(pargs_t const &... _args) const {
+            __fmt_memory_buffer<> buf;
+            __fmt_format_to<pargs_t...>(buf, *this, _args...);
+            return std::string(buf.data(), buf.size());
+        }
+
+        /// @fn: exact length format() would produce (see cxx::formatted_size).
+        _GLIBCXX_NODISCARD
+        std::size_t formatted_size(pargs_t const &... _args) const {
+            return __fmt_formatted_size<pargs_t...>(*this, _args...);
+        }
+
+        /// @fn: formats straight into an output iterator (see cxx::format_to).
+        template<typename _out_it> requires std::output_iterator<_out_it, const char &>
+        _out_it format_to(_out_it _out, pargs_t const &... _args) const {
+            if constexpr (std::is_same_v<_out_it, char *>) {
+                __fmt_fixed_buffer buf(_out);
+                __fmt_format_to<pargs_t...>(buf, *this, _args...);
+                return _out + buf.size();
+            } else {
+                __fmt_iterator_buffer<_out_it> buf(std::move(_out));
+                __fmt_format_to<pargs_t...>(buf, *this, _args...);
+                return buf.out();
+            }
+        }
+
+        /// @fn: formats into an output iterator, writing at most _n characters (see cxx::format_to_n).
+        template<typename _out_it> requires std::output_iterator<_out_it, const char &>
+        cxx::format_to_n_result<_out_it> format_to_n(_out_it _out, std::iter_difference_t<_out_it> _n, pargs_t const &... _args) const {
+            __fmt_iterator_buffer<_out_it> buf(std::move(_out), _n > 0 ? (std::size_t) _n : 0);
+            __fmt_format_to<pargs_t...>(buf, *this, _args...);
+            auto size = buf.count();
+            return { buf.out(), (std::iter_difference_t<_out_it>) size };
+        }
+    };
+
+    /// @fn: compiles a run time format string for the given argument types.
+    /// @tparam: ...pargs_t the argument types every later call will pass.
+    /// @param: _format the format string, same syntax as std::format.
+    template<typename... pargs_t>
+    _GLIBCXX_NODISCARD
+    inline compiled_format<__fmt_arg_t<pargs_t>...>
+    compile_format(std::string_view _format) {
+        return compiled_format<__fmt_arg_t<pargs_t>...>(_format);
+    }
+
+    /// @fn: prepares a block of one column of a batch and estimates its length: integers written in decimal
+    ///     get their lengths counted across the whole block (kept in _len for the write), types with a
+    ///     cheap size() are summed, and floating point gets a bound for its shortest form.
+    template<typename _ty>
+    inline std::size_t __fmt_column_block(_ty const *_v, std::size_t _n, __fmt_spec const &_s, unsigned char *_len) {
+        if (_s._width != 0) {
+            std::size_t total = 0;
+            for (std::size_t i = 0; i < _n; ++i)
+                total += __fmt_field_size(_v[i], _s);
+            return total;
+        }
+        if constexpr (__fmt_int<_ty> && sizeof(_ty) <= sizeof(std::uint64_t)) {
+            if (_s._type == 0 || _s._type == 'd')
+                return __fmt_count_digits_block(_v, _n, _len);
+            return _n * 16;
+        } else if constexpr (std::floating_point<_ty>)
+            return _n * 24;
+        else {
+            std::size_t total = 0;
+            for (std::size_t i = 0; i < _n; ++i)
+                total += __fmt_size_of(_v[i], _s);
+            return total;
+        }
+    }
+
+    /// @fn: writes one cell of a batch. decimal integers use their precomputed length: the digits are
+    ///     produced at full width (10 or 20, in 32-bit pieces of 8) without branching on the value, and the
+    ///     significant ones land in the output with fixed-size copies (the slack is overwritten later).
+    template<typename _ty>
+    inline void __fmt_column_write(__fmt_buffer &_out, _ty const &_v, __fmt_spec const &_s, unsigned char _len) {
+        if (_s._width != 0)
+            return __fmt_write_field(_out, _v, _s);
+        if constexpr (__fmt_int<_ty> && sizeof(_ty) <= sizeof(std::uint64_t)) {
+            if (_s._type == 0 || _s._type == 'd')
+                if (char *p = _out.try_reserve(33)) {
+                    std::uint64_t u = (std::uint64_t) _v;
+                    bool neg = false;
+                    if constexpr (std::is_signed_v<_ty>) {
+                        neg = _v < 0;
+                        u = neg ? 0 - (std::uint64_t) (std::int64_t) _v : u;
+                    }
+                    p[0] = '-';
+                    char digits[20 + 32];
+                    const char *first = digits + 20 - (_len - neg);
+                    if constexpr (sizeof(_ty) <= sizeof(std::uint32_t)) {
+                        __fmt_write_dec_fixed<2>(digits + 10, (std::uint32_t) (u / 100000000));
+                        __fmt_write_dec_fixed<8>(digits + 12, (std::uint32_t) (u % 100000000));
+                        std::memcpy(p + neg, first, 16);
+                    } else {
+                        __fmt_write_dec_fixed<4>(digits, (std::uint32_t) (u / 10000000000000000ull));
+                        __fmt_write_dec_fixed<8>(digits + 4, (std::uint32_t) (u / 100000000 % 100000000));
+                        __fmt_write_dec_fixed<8>(digits + 12, (std::uint32_t) (u % 100000000));
+                        std::memcpy(p + neg, first, 16);
+                        std::memcpy(p + neg + 16, first + 16, 16);
+                    }
+                    _out.commit(_len);
+                    return;
+                }
+        }
+        __fmt_writer<_ty>::write(_out, _v, _s);
+    }
+
+    /// @fn: the batch engine: rows go out in blocks, every block is sized up front (one reserve) column by
+    ///     column, then written row by row with the compiled program.
+    template<typename... pargs_t>
+    inline void __fmt_format_rows(__fmt_buffer &_out, compiled_format<pargs_t...> const &_f, std::span<pargs_t const>... _cols) {
+        constexpr std::size_t __block = 256;
+        std::size_t rows = (std::size_t) -1;
+        ((rows = std::min(rows, _cols.size())), ...);
+        if (((_cols.size() != rows) || ...))
+            throw std::invalid_argument("format_rows: columns differ in length");
+        if constexpr (sizeof...(pargs_t) == 0)
+            return;
+        else {
+            std::size_t lits = 0;
+            for (__fmt_literal const &lit : _f._lits)
+                lits += lit._len - lit._esc;
+
+            unsigned char lens[sizeof...(pargs_t)][__block];
+            for (std::size_t r = 0; r < rows; r += __block) {
+                std::size_t n = std::min(__block, rows - r);
+                [&]<std::size_t... _is>(std::index_sequence<_is...>) {
+                    std::size_t estimate = lits * n + 32;
+                    ((estimate += __fmt_column_block<pargs_t>(_cols.data() + r, n, _f._specs[_is], lens[_is])), ...);
+                    _out.reserve(estimate);
+                    for (std::size_t i = 0; i < n; ++i) {
+                        ((__fmt_put_literal(_out, _f, _is), __fmt_column_write<pargs_t>(_out, _cols[r + i], _f._specs[_is], lens[_is][i])), ...);
+                        __fmt_put_literal(_out, _f, sizeof...(pargs_t));
+                    }
+                }(std::index_sequence_for<pargs_t...> {});
+            }
+        }
+    }
+
+    /// @fn: formats a batch of uniform records (CSV / TSV lines) into one string: the compiled format is
+    ///     one row (end it with a newline), and every column holds the values of one of its fields.
+    /// @param: _f the compiled row format.
+    /// @param: _cols one span per field, all of the same length (std::invalid_argument otherwise).
+    template<typename... pargs_t>
+    _GLIBCXX_NODISCARD
+    inline std::string
+    format_rows(compiled_format<pargs_t...> const &_f, std::type_identity_t<std::span<pargs_t const>>... _cols) {
+        __fmt_tls_guard guard;
+        __fmt_format_rows<pargs_t...>(guard._buf, _f, _cols...);
+        return std::string(guard._buf.data(), guard._buf.size());
+    }
+
+    /// @fn: formats a batch of records through the thread's reusable buffer and appends it to a sink.
+    /// @return: the number of characters appended.
+    template<__fmt_sink _sink_t, typename... pargs_t>
+    inline std::size_t
+    format_rows_to(_sink_t &_sink, compiled_format<pargs_t...> const &_f, std::type_identity_t<std::span<pargs_t const>>... _cols) {
+        __fmt_tls_guard guard;
+        __fmt_format_rows<pargs_t...>(guard._buf, _f, _cols...);
+        _sink.append(guard._buf.data(), guard._buf.size());
+        return guard._buf.size();
+    }
+
+    template<std::size_t _N>
+    class format_buffer;
+
+    namespace cxx {
+        template<std::size_t _N, typename... pargs_t>
+        std::string_view format_to(format_buffer<_N> &, __fmt_string<pargs_t...>, pargs_t &&...);
+    }
+
+    /// @note: fixed-capacity output that lives on the stack; cxx::format_to appends to it and never allocates,
+    ///     whatever does not fit is dropped and reported through truncated().
+    template<std::size_t _N>
+    class format_buffer {
+    private:
+        /// @field: inline storage.
+        char _store[_N];
+
+        /// @field: number of characters held, and whether anything had to be dropped.
+        std::size_t _size = 0;
+        bool _truncated = false;
+
+        template<std::size_t _M, typename... pargs_t>
+        friend std::string_view cxx::format_to(format_buffer<_M> &, __fmt_string<pargs_t...>, pargs_t &&...);
+
+    public:
+        /// @fn: getters for the formatted characters.
+        _GLIBCXX_NODISCARD const char *data() const _GLIBCXX_NOEXCEPT { return _store; }
+        _GLIBCXX_NODISCARD std::size_t size() const _GLIBCXX_NOEXCEPT { return _size; }
+        _GLIBCXX_NODISCARD static constexpr std::size_t capacity() _GLIBCXX_NOEXCEPT { return _N; }
+        _GLIBCXX_NODISCARD std::string_view view() const _GLIBCXX_NOEXCEPT { return { _store, _size }; }
+
+        /// @fn: checks if any output had to be dropped since the last clear().
+        _GLIBCXX_NODISCARD bool truncated() const _GLIBCXX_NOEXCEPT { return _truncated; }
+
+        /// @fn: empties the buffer for reuse.
+        void clear() _GLIBCXX_NOEXCEPT { _size = 0, _truncated = false; }
+    };
+
+    namespace cxx {
+        /// @fn: formats into (the end of) a fixed-capacity stack buffer.
+        /// @return: a view of everything the buffer holds.
+        template<std::size_t _N, typename... pargs_t>
+        inline std::string_view
+        format_to(format_buffer<_N> &_buf, __fmt_string<pargs_t...> _format, pargs_t &&... _args) {
+            __fmt_fixed_buffer buf(_buf._store + _buf._size, _N - _buf._size);
+            __fmt_format_to<__fmt_arg_t<pargs_t>...>(buf, _format, _args...);
+            _buf._size += buf.size();
+            _buf._truncated |= buf.truncated();
+            return _buf.view();
+        }
+    }
+
+    /// @note: fixed-capacity string returned by value from format_inline / vformat_inline: the characters
+    ///     (NUL terminated) live inside the object, so short messages never touch the heap. output that
+    ///     does not fit is dropped, truncated() reports it and required() the length the whole output needed.
+    template<std::size_t _N>
+    class inline_string {
+    private:
+        /// @field: inline storage, with room for the terminator.
+        char _store[_N + 1];
+
+        /// @field: number of characters held, and the length of the complete output.
+        std::size_t _size = 0, _required = 0;
+
+        template<std::size_t _M, typename... pargs_t>
+        friend inline_string<_M> format_inline(__fmt_string<pargs_t...>, pargs_t &&...);
+
+        template<std::size_t _M, typename... pargs_t>
+        friend inline_string<_M> vformat_inline(const char *, pargs_t...);
+
+    public:
+        inline_string() _GLIBCXX_NOEXCEPT { _store[0] = '\0'; }
+
+        /// @fn: getters for the characters.
+        _GLIBCXX_NODISCARD const char *data() const _GLIBCXX_NOEXCEPT { return _store; }
+        _GLIBCXX_NODISCARD const char *c_str() const _GLIBCXX_NOEXCEPT { return _store; }
+        _GLIBCXX_NODISCARD std::size_t size() const _GLIBCXX_NOEXCEPT { return _size; }
+        _GLIBCXX_NODISCARD bool empty() const _GLIBCXX_NOEXCEPT { return _size == 0; }
+        _GLIBCXX_NODISCARD static constexpr std::size_t capacity() _GLIBCXX_NOEXCEPT { return _N; }
+        _GLIBCXX_NODISCARD const char *begin() const _GLIBCXX_NOEXCEPT { return _store; }
+        _GLIBCXX_NODISCARD const char *end() const _GLIBCXX_NOEXCEPT { return _store + _size; }
+        _GLIBCXX_NODISCARD std::string_view view() const _GLIBCXX_NOEXCEPT { return { _store, _size }; }
+        operator std::string_view() const _GLIBCXX_NOEXCEPT { return view(); }
+
+        /// @fn: copies the characters into a std::string.
+        _GLIBCXX_NODISCARD std::string str() const { return std::string(_store, _size); }
+
+        /// @fn: checks if the output did not fit; required() is its full length.
+        _GLIBCXX_NODISCARD bool truncated() const _GLIBCXX_NOEXCEPT { return _required > _size; }
+        _GLIBCXX_NODISCARD std::size_t required() const _GLIBCXX_NOEXCEPT { return _required; }
+    };
+
+    /// @note: an inline_string is written like the string it holds.
+    template<std::size_t _N>
+    struct __fmt_writer<inline_string<_N>> {
+        static constexpr const char *check(__fmt_spec const &_s) {
+            return __fmt_writer<std::string_view>::check(_s);
+        }
+        static void write(__fmt_buffer &_out, inline_string<_N> const &_v, __fmt_spec const &_s) {
+            __fmt_writer<std::string_view>::write(_out, _v.view(), _s);
+        }
+        static std::size_t size(inline_string<_N> const &_v, __fmt_spec const &_s) {
+            return __fmt_writer<std::string_view>::size(_v.view(), _s);
+        }
+    };
+
+    /// @fn: formats into a fixed-capacity string returned by value, with no heap allocation.
+    /// @tparam: _N the capacity (characters, the terminator not included).
+    /// @return: the (possibly truncated) output, see inline_string::truncated().
+    template<std::size_t _N, typename... pargs_t>
+    _GLIBCXX_NODISCARD
+    inline inline_string<_N>
+    format_inline(__fmt_string<pargs_t...> _format, pargs_t &&... _args) {
+        inline_string<_N> s;
+        __fmt_fixed_buffer buf(s._store, _N);
+        __fmt_format_to<__fmt_arg_t<pargs_t>...>(buf, _format, _args...);
+        s._size = buf.size(), s._required = buf.count();
+        s._store[s._size] = '\0';
+        return s;
+    }
+
+    /// @fn: formats a printf-style format into a fixed-capacity string returned by value (vformat with no
+    ///     std::string and no heap); the output is cut at _N characters like vnformat.
+    template<std::size_t _N, typename... pargs_t>
+    _GLIBCXX_NODISCARD
+    inline inline_string<_N>
+    vformat_inline(const char *_format, pargs_t... _args) {
+        inline_string<_N> s;
+        int len = std::snprintf(s._store, _N + 1, _format, _args...);
+        if (len < 0) {
+            s._store[0] = '\0';
+            return s;
+        }
+        s._required = (std::size_t) len;
+        s._size = s._required < _N ? s._required : _N;
+        return s;
+    }
+
+    template<std::size_t _N>
+    inline std::ostream &operator<<(std::ostream &_os, inline_string<_N> const &_s) {
+        return _os.write(_s.data(), (std::streamsize) _s.size());
+    }
+
+    /// @note: a format string with its arguments, formatted only once it is written somewhere (str(),
+    ///     format_to(), an ostream, or as the `{}` argument of another format); nothing is formatted if it
+    ///     is dropped. lvalue arguments are held by reference (it must not outlive them), rvalues by value.
+    template<typename... pargs_t>
+    class lazy_format {
+    private:
+        /// @field: the checked and split format string, and the captured arguments.
+        __fmt_string<pargs_t...> _format;
+        std::tuple<pargs_t...> _args;
+
+        template<typename>
+        friend struct __fmt_writer;
+
+        /// @fn: formats into an engine buffer.
+        void _write(__fmt_buffer &_out) const {
+            std::apply([&](auto const &... _as) {
+                __fmt_format_to<__fmt_arg_t<pargs_t>...>(_out, _format, _as...);
+            }, _args);
+        }
+
+    public:
+        template<typename... _ts>
+        lazy_format(__fmt_string<pargs_t...> _format, _ts &&... _args)
+            : _format(_format), _args(std::forward<_ts>(_args)...) {}
+
+        /// @fn: formats a string.
+        _GLIBCXX_NODISCARD
+        std::string str() const {
+            __fmt_memory_buffer<> buf;
+            _write(buf);
+            return std::string(buf.data(), buf.size());
+        }
+
+        /// @fn: exact length str() would produce (see cxx::formatted_size).
+        _GLIBCXX_NODISCARD
+        std::size_t formatted_size() const {
+            return std::apply([&](auto const &... _as) {
+                return __fmt_formatted_size<__fmt_arg_t<pargs_t>...>(_format, _as...);
+            }, _args);
+        }
+
+        /// @fn: formats straight into an output iterator (see cxx::format_to).
+        template<typename _out_it> requires std::output_iterator<_out_it, const char &>
+        _out_it format_to(_out_it _out) const {
+            __fmt_iterator_buffer<_out_it> buf(std::move(_out));
+            _write(buf);
+            return buf.out();
+        }
+
+        /// @fn: formats into a stream.
+        template<typename _traits>
+        friend std::basic_ostream<char, _traits> &operator<<(std::basic_ostream<char, _traits> &_os, lazy_format const &_f) {
+            __fmt_memory_buffer<> buf;
+            _f._write(buf);
+            return _os.write(buf.data(), (std::streamsize) buf.size());
+        }
+    };
+
+    /// @note: how a lazy_format captures an argument, by reference for lvalues and by value otherwise.
+    template<typename _ty>
+    using __fmt_lazy_t = std::conditional_t<std::is_lvalue_reference_v<_ty>, std::remove_reference_t<_ty> const &,
+        std::decay_t<_ty>>;
+
+    /// @fn: captures a format string and its arguments without formatting them.
+    /// @tparam: ...pargs_t packed args (same as std::format).
+    /// @param: _format the format string (checked at compile time).
+    /// @param: _args format parameters, referenced (lvalues) or moved in (rvalues).
+    template<typename... pargs_t>
+    _GLIBCXX_NODISCARD
+    inline lazy_format<__fmt_lazy_t<pargs_t>...>
+    format_lazy(__fmt_string<pargs_t...> _format, pargs_t &&... _args) {
+        return lazy_format<__fmt_lazy_t<pargs_t>...>(_format, std::forward<pargs_t>(_args)...);
+    }
+
+    /// @note: a lazy format is formatted in place when it is the argument of another one (it takes no spec).
+    template<typename... pargs_t>
+    struct __fmt_writer<lazy_format<pargs_t...>> {
+        static constexpr const char *check(__fmt_spec const &_s) {
+            return _s._type == 0 && _s._prec < 0 ? nullptr : "a lazy format takes no spec";
+        }
+        static void write(__fmt_buffer &_out, lazy_format<pargs_t...> const &_v, __fmt_spec const &) {
+            _v._write(_out);
+        }
+        static std::size_t size(lazy_format<pargs_t...> const &_v, __fmt_spec const &) {
+            return _v.formatted_size();
+        }
+    };
+
+    /// @fn: transcodes UTF-8 to UTF-16 / UTF-32 / wchar_t (UTF-16 or UTF-32 by its size), invalid sequences
+    ///     become U+FFFD; ASCII runs take the SSE2 path.
+    /// @param: _s the UTF-8 text.
+    template<__fmt_wide_char _u>
+    _GLIBCXX_NODISCARD
+    inline std::basic_string<_u>
+    __utf8_to(std::string_view _s) {
+        std::basic_string<_u> out(_s.size(), _u());
+        out.resize((std::size_t) (__utf8_decode(_s.data(), _s.data() + _s.size(), out.data()) - out.data()));
+        return out;
+    }
+
+    _GLIBCXX_NODISCARD inline std::u16string utf8_to_utf16(std::string_view _s) { return __utf8_to<char16_t>(_s); }
+    _GLIBCXX_NODISCARD inline std::u32string utf8_to_utf32(std::string_view _s) { return __utf8_to<char32_t>(_s); }
+    _GLIBCXX_NODISCARD inline std::wstring utf8_to_wide(std::string_view _s) { return __utf8_to<wchar_t>(_s); }
+
+    /// @fn: transcodes UTF-16 / UTF-32 / wchar_t text to UTF-8, unpaired surrogates become U+FFFD.
+    /// @param: _s the wide text.
+    template<__fmt_wide_char _u>
+    _GLIBCXX_NODISCARD
+    inline std::string
+    __utf8_from(std::basic_string_view<_u> _s) {
+        std::string out(_s.size() * (sizeof(_u) == 2 ? 3 : 4), '\0');
+        out.resize((std::size_t) (__utf8_encode(_s.data(), _s.data() + _s.size(), out.data()) - out.data()));
+        return out;
+    }
+
+    _GLIBCXX_NODISCARD inline std::string utf16_to_utf8(std::u16string_view _s) { return __utf8_from(_s); }
+    _GLIBCXX_NODISCARD inline std::string utf32_to_utf8(std::u32string_view _s) { return __utf8_from(_s); }
+    _GLIBCXX_NODISCARD inline std::string wide_to_utf8(std::wstring_view _s) { return __utf8_from(_s); }
+
+    /// @fn: number of characters hex_encode / base64_encode produce for _n bytes.
+    _GLIBCXX_NODISCARD constexpr std::size_t hex_size(std::size_t _n) _GLIBCXX_NOEXCEPT { return _n * 2; }
+    _GLIBCXX_NODISCARD constexpr std::size_t base64_size(std::size_t _n) _GLIBCXX_NOEXCEPT { return (_n + 2) / 3 * 4; }
+
+    /// @fn: hex encodes bytes into a caller buffer (vectorized with AVX2 / SSE2).
+    /// @param: _out room for hex_size(_n) characters (no terminator is written).
+    /// @param: _data the bytes, _n their count.
+    /// @param: _upper upper case digits.
+    /// @return: past the last character written.
+    inline char *hex_encode(char *_out, const void *_data, std::size_t _n, bool _upper = false) _GLIBCXX_NOEXCEPT {
+        return __fmt_hex_encode(_out, (const unsigned char *) _data, _n, _upper);
+    }
+
+    /// @fn: base64 encodes bytes (standard alphabet, padded) into a caller buffer (vectorized with AVX2 / SSSE3).
+    /// @param: _out room for base64_size(_n) characters (no terminator is written).
+    /// @param: _data the bytes, _n their count.
+    /// @return: past the last character written.
+    inline char *base64_encode(char *_out, const void *_data, std::size_t _n) _GLIBCXX_NOEXCEPT {
+        return __fmt_base64_encode(_out, (const unsigned char *) _data, _n);
+    }
+
+    /// @note: calibration of the time stamp counter against the system clock: a pair of readings taken
+    ///     together and the length of a tick (in nanoseconds, 32.32 fixed point).
+    struct __tsc_calibration {
+        std::uint64_t _tsc = 0;
+        std::int64_t _ns = 0;
+        std::uint64_t _scale = 0;
+    };
+
+    /// @fn: calibrates the time stamp counter once (a ~10ms spin on the first call); the scale stays 0
+    ///     where there is no invariant (constant rate) counter.
+    inline __tsc_calibration const &__tsc_calibrate() _GLIBCXX_NOEXCEPT {
+        static const __tsc_calibration calibration = []() {
+            __tsc_calibration c;
+#if defined(__x86_64__) || defined(__i386__)
+            unsigned a, b, cx, d;
+            if (!__get_cpuid(0x80000007, &a, &b, &cx, &d) || !(d & (1u << 8)))
+                return c;
+            using clock = std::chrono::system_clock;
+            auto ns = [](clock::time_point _t) {
+                return (std::int64_t) std::chrono::duration_cast<std::chrono::nanoseconds>(_t.time_since_epoch()).count();
+            };
+            std::uint64_t t0 = __rdtsc();
+            std::int64_t s0 = ns(clock::now()), s1;
+            while ((s1 = ns(clock::now())) - s0 < 10000000);
+            std::uint64_t t1 = __rdtsc();
+            if (t1 > t0)
+                c = { t0, s0, ((std::uint64_t) (s1 - s0) << 32) / (t1 - t0) };
+#endif
+            return c;
+        }();
+        return calibration;
+    }
+
+    /// @note: clock that reads the CPU time stamp counter (no system call, no vDSO page) and converts it
+    ///     to system clock time with the calibration made on first use; its time points are system clock
+    ///     time points, so they format as timestamps. falls back to the system clock without an invariant
+    ///     counter. the scale is measured once over ~10ms, so it drifts from the (NTP adjusted) system clock
+    ///     by a few ppm: meant for log timestamps, not for long lived wall clock time.
+    struct tsc_clock {
+        using duration = std::chrono::system_clock::duration;
+        using rep = duration::rep;
+        using period = duration::period;
+        using time_point = std::chrono::system_clock::time_point;
+        static constexpr bool is_steady = false;
+
+        /// @fn: the current time.
+        _GLIBCXX_NODISCARD static time_point now() _GLIBCXX_NOEXCEPT {
+#if defined(__x86_64__) || defined(__i386__)
+            __tsc_calibration const &c = __tsc_calibrate();
+            if (c._scale != 0) {
+                /// ticks * scale >> 32 in 64-bit halves (exact, no 128-bit type, so 32-bit targets take it too).
+                std::uint64_t ticks = __rdtsc() - c._tsc;
+                std::uint64_t lo = c._scale & 0xffffffffu, hi = c._scale >> 32;
+                auto ns = c._ns + (std::int64_t) (ticks * hi + (ticks >> 32) * lo + (((ticks & 0xffffffffu) * lo) >> 32));
+                return time_point(std::chrono::duration_cast<duration>(std::chrono::nanoseconds(ns)));
+            }
+#endif
+            return std::chrono::system_clock::now();
+        }
+    };
+}
+#endif
 #endif
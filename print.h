@@ -33,6 +33,17 @@
 /// @uses: std::vformat, std::wformat
 #include "format.h"
 
+#if __cplusplus >= 202002L
+/// @uses: std::unordered_map<?>
+#include <unordered_map>
+
+/// @uses: std::vector<?>
+#include <vector>
+
+/// @uses: std::atomic<?>
+#include <atomic>
+#endif
+
 namespace std
 _GLIBCXX_VISIBILITY(default) {
     /// @fn: prints out to stdout, with formatted args.
@@ -146,5 +157,408 @@ _GLIBCXX_VISIBILITY(default) {
         if (auto _f = wformat(_format, _args...) + L'\n'; _f.length() > 0)
             _stream << _f;
     }
+
+#if __cplusplus >= 202002L
+    /// @note: severity of a level-gated print, in increasing order.
+    enum class print_level : unsigned char {
+        trace, debug, info, warning, error,
+    };
+
+    /// @note: lowest level that is printed, shared by every thread.
+    inline std::atomic<print_level> __print_threshold { print_level::info };
+
+    /// @fn: sets the lowest level that is printed.
+    inline void set_print_level(print_level _level) _GLIBCXX_NOEXCEPT {
+        __print_threshold.store(_level, std::memory_order_relaxed);
+    }
+
+    /// @fn: checks if a level is printed, a single relaxed load.
+    _GLIBCXX_NODISCARD
+    inline bool print_enabled(print_level _level) _GLIBCXX_NOEXCEPT {
+        return _level >= __print_threshold.load(std::memory_order_relaxed);
+    }
+
+    /// @fn: prints out to stdout with formatted args, if the level is enabled; a disabled level returns
+    ///     before anything is formatted (pass a lazy_format to defer expensive arguments as well).
+    /// @tparam: ...pargs_t packed args (same as std::format).
+    /// @param: _level the severity of the output.
+    /// @param: _format the format string, same syntax as std::format.
+    /// @param: _args format parameters.
+    template<typename... pargs_t>
+    inline void
+    print(print_level _level, __fmt_string<pargs_t...> _format, pargs_t &&... _args) {
+        if (!print_enabled(_level))
+            return;
+        __fmt_memory_buffer<> buf;
+        __fmt_format_to<__fmt_arg_t<pargs_t>...>(buf, _format, _args...);
+        fwrite(buf.data(), 1ul, buf.size(), stdout);
+    }
+
+    /// @fn: prints a line out to stdout with formatted args, if the level is enabled.
+    template<typename... pargs_t>
+    inline void
+    println(print_level _level, __fmt_string<pargs_t...> _format, pargs_t &&... _args) {
+        if (!print_enabled(_level))
+            return;
+        __fmt_memory_buffer<> buf;
+        __fmt_format_to<__fmt_arg_t<pargs_t>...>(buf, _format, _args...);
+        buf.push_back('\n');
+        fwrite(buf.data(), 1ul, buf.size(), stdout);
+    }
+
+    /// @fn: writes out to a file pointer with a wide `{}` format string; the text is formatted as UTF-8 and
+    ///     written as bytes, wide literals and arguments are transcoded on the way (no swprintf / wcout).
+    ///     named apart from print / vprintln_nonunicode, which take printf-style format strings.
+    /// @tparam: ...pargs_t packed args (same as std::format).
+    /// @param: _fp the file pointer.
+    /// @param: _format the wide format string, same syntax as std::format.
+    /// @param: _args format parameters to format the string and print to the file pointer.
+    template<typename... pargs_t>
+    inline void
+    print_utf8(FILE *_fp, __fmt_wstring<pargs_t...> _format, pargs_t &&... _args) {
+        __fmt_memory_buffer<> buf;
+        __fmt_format_to<__fmt_arg_t<pargs_t>...>(buf, _format, _args...);
+        fwrite(buf.data(), 1ul, buf.size(), _fp);
+    }
+
+    /// @fn: writes a line out to a file pointer with a wide `{}` format string (as UTF-8).
+    template<typename... pargs_t>
+    inline void
+    println_utf8(FILE *_fp, __fmt_wstring<pargs_t...> _format, pargs_t &&... _args) {
+        __fmt_memory_buffer<> buf;
+        __fmt_format_to<__fmt_arg_t<pargs_t>...>(buf, _format, _args...);
+        buf.push_back('\n');
+        fwrite(buf.data(), 1ul, buf.size(), _fp);
+    }
+
+    /// @fn: writes out to stdout with a wide `{}` format string (as UTF-8).
+    template<typename... pargs_t>
+    inline void
+    print_utf8(__fmt_wstring<pargs_t...> _format, pargs_t &&... _args) {
+        print_utf8(stdout, _format, std::forward<pargs_t>(_args)...);
+    }
+
+    /// @fn: writes a line out to stdout with a wide `{}` format string (as UTF-8).
+    template<typename... pargs_t>
+    inline void
+    println_utf8(__fmt_wstring<pargs_t...> _format, pargs_t &&... _args) {
+        println_utf8(stdout, _format, std::forward<pargs_t>(_args)...);
+    }
+
+    /// @note: record layout of a binary log (host byte order). a format string is defined once, the first
+    ///     time it is logged ('D', u32 id, u8 argc, u32 length, text); every call after that is an event
+    ///     ('E', or 'L' for println, u32 id) followed by one tagged argument per field.
+    enum class __binlog_record : char {
+        define = 'D',
+        event = 'E',
+        line = 'L',
+    };
+
+    /// @note: argument kinds; the tag byte is the kind in the low nibble and the size class in the high one.
+    enum class __binlog_kind : unsigned char {
+        sint, uint, real, boolean, character, string, pointer,
+    };
+
+    /// @note: size classes, the fixed sizes an argument can have (0 for strings, which carry a length);
+    ///     a nibble cannot hold sizeof(long double) itself.
+    inline constexpr std::size_t __binlog_sizes[] = { 0, 1, 2, 4, 8, sizeof(long double) };
+
+    /// @note: argument types a binary log can record without formatting them (raw bytes, or a copy of
+    ///     the characters for strings).
+    template<typename _ty>
+    concept __binlog_arg = (std::integral<_ty> && !__fmt_wide_char<_ty> && sizeof(_ty) <= sizeof(std::uint64_t))
+        || std::floating_point<_ty> || std::convertible_to<_ty, std::string_view>
+        || std::is_pointer_v<_ty> || std::same_as<_ty, std::nullptr_t>;
+
+    /// @fn: the tag byte of an argument type.
+    template<typename _ty>
+    constexpr unsigned char __binlog_tag() _GLIBCXX_NOEXCEPT {
+        __binlog_kind kind;
+        std::size_t size = sizeof(_ty);
+        if constexpr (std::same_as<_ty, bool>)
+            kind = __binlog_kind::boolean;
+        else if constexpr (std::same_as<_ty, char>)
+            kind = __binlog_kind::character;
+        else if constexpr (std::integral<_ty>)
+            kind = std::is_signed_v<_ty> ? __binlog_kind::sint : __binlog_kind::uint;
+        else if constexpr (std::floating_point<_ty>)
+            kind = __binlog_kind::real;
+        else if constexpr (std::convertible_to<_ty, std::string_view>)
+            kind = __binlog_kind::string, size = 0;
+        else
+            kind = __binlog_kind::pointer, size = sizeof(const void *);
+        /// every recordable type has a class, running past the table fails the constant evaluation.
+        unsigned char cls = 0;
+        while (__binlog_sizes[cls] != size)
+            ++cls;
+        return (unsigned char) ((unsigned char) kind | cls << 4);
+    }
+
+    /// @fn: number of bytes an argument takes in a record (tag included).
+    template<typename _ty>
+    inline std::size_t __binlog_size(_ty const &_v) _GLIBCXX_NOEXCEPT {
+        if constexpr (std::convertible_to<_ty, std::string_view> && !std::same_as<_ty, std::nullptr_t>) {
+            if constexpr (std::is_pointer_v<_ty>)
+                return 1 + sizeof(std::uint32_t) + (_v ? std::char_traits<char>::length(_v) : 6);
+            else
+                return 1 + sizeof(std::uint32_t) + std::string_view(_v).size();
+        } else if constexpr (std::is_pointer_v<_ty> || std::same_as<_ty, std::nullptr_t>)
+            return 1 + sizeof(const void *);
+        else
+            return 1 + sizeof(_ty);
+    }
+
+    /// @fn: writes an argument into a record, returns the position past it.
+    template<typename _ty>
+    inline char *__binlog_put(char *_p, _ty const &_v) _GLIBCXX_NOEXCEPT {
+        constexpr unsigned char tag = __binlog_tag<_ty>();
+        *_p++ = (char) tag;
+        if constexpr (std::convertible_to<_ty, std::string_view> && !std::same_as<_ty, std::nullptr_t>) {
+            std::string_view s;
+            if constexpr (std::is_pointer_v<_ty>)
+                s = _v ? std::string_view(_v) : std::string_view("(null)");
+            else
+                s = _v;
+            std::uint32_t n = (std::uint32_t) s.size();
+            std::memcpy(_p, &n, sizeof(n));
+            std::memcpy(_p + sizeof(n), s.data(), s.size());
+            return _p + sizeof(n) + s.size();
+        } else if constexpr (std::is_pointer_v<_ty> || std::same_as<_ty, std::nullptr_t>) {
+            const void *v = _v;
+            std::memcpy(_p, &v, sizeof(v));
+            return _p + sizeof(v);
+        } else {
+            std::memcpy(_p, &_v, sizeof(_ty));
+            return _p + sizeof(_ty);
+        }
+    }
+
+    /// @note: deferred binary log. print(binlog&, ...) records the id of the format string and the raw
+    ///     argument bytes, no formatting happens on the calling thread; binlog_decode() rebuilds the text
+    ///     later (or offline, from a file written by flush()). the format strings are checked at compile
+    ///     time like std::format's, and are written into the log once, the first time they are seen.
+    ///     a binlog is not synchronized, use one per thread.
+    class binlog {
+    private:
+        /// @field: pending bytes, and how many of them are used.
+        std::unique_ptr<char[]> _data;
+        std::size_t _size = 0, _cap;
+
+        /// @field: file that full buffers are written to (nullptr keeps everything in memory).
+        FILE *_fp;
+
+        /// @field: ids of the format strings seen so far, with a small direct mapped cache in front
+        ///     (keyed on the address of the format string) so a hit costs one compare.
+        struct _slot { const char *_str = nullptr; std::size_t _len = 0; std::uint32_t _id = 0; };
+        std::array<_slot, 64> _cache {};
+        std::unordered_map<std::string_view, std::uint32_t> _ids;
+
+        /// @fn: room for _n more bytes; writes the pending bytes out (or grows) when there is none.
+        char *_reserve(std::size_t _n) {
+            if (_size + _n <= _cap)
+                return _data.get() + _size;
+            return _reserve_slow(_n);
+        }
+
+        __attribute__((__noinline__)) char *_reserve_slow(std::size_t _n) {
+            if (_fp) {
+                flush();
+                if (_n <= _cap)
+                    return _data.get();
+            }
+            std::size_t cap = _size + _n > _cap * 2 ? _size + _n : _cap * 2;
+            std::unique_ptr<char[]> data(new char[cap]);
+            std::memcpy(data.get(), _data.get(), _size);
+            _data = std::move(data);
+            _cap = cap;
+            return _data.get() + _size;
+        }
+
+        /// @fn: id of a format string, defining it in the log the first time it is seen.
+        std::uint32_t _id(std::string_view _format, std::size_t _argc) {
+            _slot &slot = _cache[((std::uintptr_t) _format.data() >> 3) % _cache.size()];
+            if (slot._str == _format.data() && slot._len == _format.size()) [[likely]]
+                return slot._id;
+            return _define(slot, _format, _argc);
+        }
+
+        __attribute__((__noinline__)) std::uint32_t _define(_slot &_to, std::string_view _format, std::size_t _argc) {
+            auto [it, fresh] = _ids.try_emplace(_format, (std::uint32_t) _ids.size());
+            if (fresh) {
+                std::uint32_t n = (std::uint32_t) _format.size();
+                char *p = _reserve(2 + sizeof(it->second) + sizeof(n) + _format.size());
+                *p++ = (char) __binlog_record::define;
+                std::memcpy(p, &it->second, sizeof(it->second));
+                p += sizeof(it->second);
+                *p++ = (char) _argc;
+                std::memcpy(p, &n, sizeof(n));
+                std::memcpy(p + sizeof(n), _format.data(), _format.size());
+                _size += 2 + sizeof(it->second) + sizeof(n) + _format.size();
+            }
+            _to = { _format.data(), _format.size(), it->second };
+            return it->second;
+        }
+
+    public:
+        /// @note: in memory log (grows as needed), or one that writes to _fp whenever _capacity bytes are pending.
+        explicit binlog(FILE *_fp = nullptr, std::size_t _capacity = 1 << 16)
+            : _data(new char[_capacity ? _capacity : 1]), _cap(_capacity ? _capacity : 1), _fp(_fp) {}
+        binlog(binlog const &) = delete;
+        binlog &operator=(binlog const &) = delete;
+        ~binlog() { if (_fp) flush(); }
+
+        /// @fn: records one call; the hot path is a cache lookup and a copy of the argument bytes.
+        template<typename... pargs_t> requires (__binlog_arg<pargs_t> && ...)
+        void record(__binlog_record _kind, std::string_view _format, pargs_t const &... _args) {
+            std::uint32_t id = _id(_format, sizeof...(pargs_t));
+            std::size_t n = 1 + sizeof(id) + (std::size_t(0) + ... + __binlog_size(_args));
+            char *p = _reserve(n);
+            *p++ = (char) _kind;
+            std::memcpy(p, &id, sizeof(id));
+            p += sizeof(id);
+            ((p = __binlog_put(p, _args)), ...);
+            _size += n;
+        }
+
+        /// @fn: getter for the pending (not yet flushed) bytes.
+        _GLIBCXX_NODISCARD std::string_view bytes() const _GLIBCXX_NOEXCEPT { return { _data.get(), _size }; }
+
+        /// @fn: writes the pending bytes to the file (if there is one) and drops them.
+        void flush() {
+            if (_fp && _size)
+                fwrite(_data.get(), 1ul, _size, _fp);
+            _size = 0;
+        }
+
+        /// @fn: drops the pending bytes and forgets the format strings, so what is recorded next decodes
+        ///     on its own.
+        void clear() {
+            _size = 0;
+            _cache = {};
+            _ids.clear();
+        }
+    };
+
+    /// @fn: records a formatted print into a binary log instead of formatting it.
+    /// @tparam: ...pargs_t packed args (integers, floating point, characters, strings and pointers).
+    /// @param: _log the binary log.
+    /// @param: _format the format string, same syntax as std::format.
+    /// @param: _args format parameters, copied into the log as they are.
+    template<typename... pargs_t> requires (__binlog_arg<__fmt_arg_t<pargs_t>> && ...)
+    inline void
+    print(binlog &_log, __fmt_string<pargs_t...> _format, pargs_t &&... _args) {
+        _log.record<__fmt_arg_t<pargs_t>...>(__binlog_record::event, _format._str, _args...);
+    }
+
+    /// @fn: records a formatted print of a line into a binary log.
+    template<typename... pargs_t> requires (__binlog_arg<__fmt_arg_t<pargs_t>> && ...)
+    inline void
+    println(binlog &_log, __fmt_string<pargs_t...> _format, pargs_t &&... _args) {
+        _log.record<__fmt_arg_t<pargs_t>...>(__binlog_record::line, _format._str, _args...);
+    }
+
+    /// @note: a format string as the decoder keeps it, split once when its definition is read.
+    struct __binlog_format {
+        std::string _str;
+        std::vector<__fmt_literal> _lits;
+        std::vector<__fmt_spec> _specs;
+    };
+
+    /// @fn: reads a fixed size value out of a record, throws when the log ends in the middle of one.
+    template<typename _ty>
+    inline _ty __binlog_get(std::string_view _in, std::size_t &_pos) {
+        if (_in.size() - _pos < sizeof(_ty))
+            throw std::invalid_argument("binlog: truncated record");
+        _ty v;
+        std::memcpy(&v, _in.data() + _pos, sizeof(_ty));
+        _pos += sizeof(_ty);
+        return v;
+    }
+
+    /// @fn: formats one recorded argument with the writer of the type it was recorded as.
+    inline void __binlog_write(__fmt_buffer &_out, std::string_view _in, std::size_t &_pos, __fmt_spec const &_s) {
+        auto tag = __binlog_get<unsigned char>(_in, _pos);
+        if ((std::size_t) (tag >> 4) >= std::size(__binlog_sizes))
+            throw std::invalid_argument("binlog: unknown argument tag");
+        std::size_t size = __binlog_sizes[tag >> 4];
+        switch ((__binlog_kind) (tag & 0xf)) {
+            case __binlog_kind::sint: {
+                std::int64_t v = size == 1 ? __binlog_get<std::int8_t>(_in, _pos) : size == 2 ? __binlog_get<std::int16_t>(_in, _pos)
+                    : size == 4 ? __binlog_get<std::int32_t>(_in, _pos) : __binlog_get<std::int64_t>(_in, _pos);
+                return __fmt_write_field<std::int64_t>(_out, v, _s);
+            }
+            case __binlog_kind::uint: {
+                std::uint64_t v = size == 1 ? __binlog_get<std::uint8_t>(_in, _pos) : size == 2 ? __binlog_get<std::uint16_t>(_in, _pos)
+                    : size == 4 ? __binlog_get<std::uint32_t>(_in, _pos) : __binlog_get<std::uint64_t>(_in, _pos);
+                return __fmt_write_field<std::uint64_t>(_out, v, _s);
+            }
+            case __binlog_kind::real:
+                if (size == sizeof(float))
+                    return __fmt_write_field<float>(_out, __binlog_get<float>(_in, _pos), _s);
+                if (size == sizeof(double))
+                    return __fmt_write_field<double>(_out, __binlog_get<double>(_in, _pos), _s);
+                return __fmt_write_field<long double>(_out, __binlog_get<long double>(_in, _pos), _s);
+            case __binlog_kind::boolean:
+                return __fmt_write_field<bool>(_out, __binlog_get<bool>(_in, _pos), _s);
+            case __binlog_kind::character:
+                return __fmt_write_field<char>(_out, __binlog_get<char>(_in, _pos), _s);
+            case __binlog_kind::string: {
+                auto n = __binlog_get<std::uint32_t>(_in, _pos);
+                if (_in.size() - _pos < n)
+                    throw std::invalid_argument("binlog: truncated record");
+                __fmt_write_field<std::string_view>(_out, _in.substr(_pos, n), _s);
+                _pos += n;
+                return;
+            }
+            case __binlog_kind::pointer:
+                return __fmt_write_field<const void *>(_out, __binlog_get<const void *>(_in, _pos), _s);
+        }
+        throw std::invalid_argument("binlog: unknown argument tag");
+    }
+
+    /// @fn: rebuilds the text of a binary log (the bytes of binlog::bytes(), or of a file written by
+    ///     binlog::flush()), format strings are split with the run time parser as their definitions come up.
+    /// @param: _in the recorded bytes, starting at a record boundary.
+    /// @return: the text print / println would have produced, throws std::invalid_argument on a bad log.
+    _GLIBCXX_NODISCARD
+    inline std::string
+    binlog_decode(std::string_view _in) {
+        std::vector<__binlog_format> formats;
+        __fmt_memory_buffer<> buf;
+        for (std::size_t pos = 0; pos < _in.size();) {
+            auto kind = (__binlog_record) _in[pos++];
+            auto id = __binlog_get<std::uint32_t>(_in, pos);
+            if (kind == __binlog_record::define) {
+                std::size_t argc = __binlog_get<unsigned char>(_in, pos);
+                auto n = __binlog_get<std::uint32_t>(_in, pos);
+                if (_in.size() - pos < n)
+                    throw std::invalid_argument("binlog: truncated record");
+                if (id >= formats.size())
+                    formats.resize(id + 1);
+                __binlog_format &f = formats[id];
+                f._str.assign(_in.data() + pos, n);
+                f._lits.assign(argc + 1, {});
+                f._specs.assign(argc, {});
+                if (const char *err = __fmt_parse(std::string_view(f._str), f._lits.data(), f._specs.data(), argc))
+                    throw std::invalid_argument(err);
+                pos += n;
+                continue;
+            }
+            /// an id past the last definition, or in a gap left below it, has no format.
+            if ((kind != __binlog_record::event && kind != __binlog_record::line) || id >= formats.size()
+                || formats[id]._lits.empty())
+                throw std::invalid_argument("binlog: bad record");
+            __binlog_format const &f = formats[id];
+            for (std::size_t i = 0; i < f._specs.size(); ++i) {
+                __fmt_put_literal(buf, f, i);
+                __binlog_write(buf, _in, pos, f._specs[i]);
+            }
+            __fmt_put_literal(buf, f, f._specs.size());
+            if (kind == __binlog_record::line)
+                buf.push_back('\n');
+        }
+        return std::string(buf.data(), buf.size());
+    }
+#endif
 }
 #endif
@@ -0,0 +1,312 @@
+/*
+ *		@brief: This header is an extension of the libstdc++ project, adding scan(), the parsing counterpart of format().
+ *
+ *		This file is part of CXX (https://github.com/seanhobeck/cxx).
+ *		Copyright (c) 2024 Sean Hobeck.
+ *
+ *		This program is free software: you can redistribute it and/or modify
+ *		it under the terms of the GNU General Public License as published by
+ *		the Free Software Foundation, either version 3 of the License, or
+ *		(at your option) any later version.
+ *
+ *		This program is distributed in the hope that it will be useful, but
+ *		WITHOUT ANY WARRANTY; without even the implied warranty of
+ *		MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ *		General Public License for more details.
+ *
+ *		You should have received a copy of the GNU General Public License
+ *		along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ *		@date    17 / 10 / 26
+ *
+ */
+
+#ifndef CXX_SCAN_H
+#define CXX_SCAN_H
+
+/// @uses: __fmt_parse, __fmt_spec, __fmt_literal, __fmt_int<?>, __fmt_compile_error
+#include "format.h"
+
+#if __cplusplus >= 202002L
+/// @uses: std::string_view
+#include <string_view>
+
+/// @uses: std::string
+#include <string>
+
+/// @uses: std::from_chars, std::chars_format
+#include <charconv>
+
+/// @uses: std::errc
+#include <system_error>
+
+/// @uses: std::memchr, std::memcmp
+#include <cstring>
+
+namespace std
+_GLIBCXX_VISIBILITY(default) {
+    /// @note: outcome of a scan(), in the manner of std::from_chars_result.
+    struct scan_result {
+        /// @field: number of arguments that were stored (in order, the first ones).
+        std::size_t count = 0;
+
+        /// @field: the input after the match, or from where matching stopped.
+        std::string_view rest;
+
+        /// @field: std::errc {} on a match, std::errc::invalid_argument when the input does not match the
+        ///     pattern, std::errc::result_out_of_range when a number does not fit its argument.
+        std::errc ec {};
+
+        /// @fn: checks if the whole pattern matched.
+        explicit operator bool() const _GLIBCXX_NOEXCEPT { return ec == std::errc {}; }
+    };
+
+    /// @fn: checks for the characters a space in a pattern matches (and fields skip in front of them).
+    constexpr bool __scan_space(char _c) _GLIBCXX_NOEXCEPT {
+        return _c == ' ' || (_c >= '\t' && _c <= '\r');
+    }
+
+    /// @fn: skips whitespace.
+    inline const char *__scan_skip(const char *_p, const char *_end) _GLIBCXX_NOEXCEPT {
+        while (_p != _end && __scan_space(*_p))
+            ++_p;
+        return _p;
+    }
+
+    /// @note: reads one argument of type _ty; check() validates a spec for it at compile time (like the
+    ///     writers of format.h) and read() parses the value at _p, moving _p past it. _stop is the character
+    ///     that ends a string field: the first of the literal text after it, ' ' for any whitespace, or 0
+    ///     for the rest of the input.
+    template<typename _ty>
+    struct __scan_reader;
+
+    /// @note: integers are parsed with std::from_chars, in decimal or the base of the type (`{:x}`, `{:o}`,
+    ///     `{:b}`); a leading '+' is accepted like scanf does.
+    template<__fmt_int _ty>
+    struct __scan_reader<_ty> {
+        static constexpr const char *check(__fmt_spec const &_s) {
+            if (_s._prec >= 0)
+                return "precision is not allowed when scanning an integer";
+            return _s._type == 0 || _s._type == 'd' || _s._type == 'x' || _s._type == 'X' || _s._type == 'o'
+                || _s._type == 'b' ? nullptr : "invalid presentation type for an integer";
+        }
+        static std::errc read(const char *&_p, const char *_end, _ty &_v, __fmt_spec const &_s, char) {
+            const char *p = __scan_skip(_p, _end);
+            if (_end - p > 1 && *p == '+' && p[1] != '-')
+                ++p;
+            int base = _s._type == 'x' || _s._type == 'X' ? 16 : _s._type == 'o' ? 8 : _s._type == 'b' ? 2 : 10;
+            auto [ptr, ec] = std::from_chars(p, _end, _v, base);
+            if (ec == std::errc {})
+                _p = ptr;
+            return ec;
+        }
+    };
+
+    /// @note: floating point numbers are parsed with std::from_chars, any notation by default, or only
+    ///     the one of the type (`{:f}`, `{:e}`, `{:g}`, `{:a}`).
+    template<std::floating_point _ty>
+    struct __scan_reader<_ty> {
+        static constexpr const char *check(__fmt_spec const &_s) {
+            if (_s._prec >= 0)
+                return "precision is not allowed when scanning a floating point number";
+            return _s._type == 0 || _s._type == 'f' || _s._type == 'e' || _s._type == 'g' || _s._type == 'a'
+                ? nullptr : "invalid presentation type for a floating point number";
+        }
+        static std::errc read(const char *&_p, const char *_end, _ty &_v, __fmt_spec const &_s, char) {
+            const char *p = __scan_skip(_p, _end);
+            if (_end - p > 1 && *p == '+' && p[1] != '-')
+                ++p;
+            std::chars_format fmt = _s._type == 'f' ? std::chars_format::fixed : _s._type == 'e'
+                ? std::chars_format::scientific : _s._type == 'a' ? std::chars_format::hex : std::chars_format::general;
+            auto [ptr, ec] = std::from_chars(p, _end, _v, fmt);
+            if (ec == std::errc {})
+                _p = ptr;
+            return ec;
+        }
+    };
+
+    /// @note: booleans are `true` / `false` or `1` / `0`.
+    template<>
+    struct __scan_reader<bool> {
+        static constexpr const char *check(__fmt_spec const &_s) {
+            return _s._type == 0 && _s._prec < 0 ? nullptr : "invalid spec for a bool";
+        }
+        static std::errc read(const char *&_p, const char *_end, bool &_v, __fmt_spec const &, char) {
+            const char *p = __scan_skip(_p, _end);
+            std::size_t n = (std::size_t) (_end - p);
+            std::size_t len = n >= 4 && !std::memcmp(p, "true", 4) ? (_v = true, 4)
+                : n >= 5 && !std::memcmp(p, "false", 5) ? (_v = false, 5)
+                : n >= 1 && (*p == '0' || *p == '1') ? (_v = *p == '1', 1) : 0;
+            if (len == 0)
+                return std::errc::invalid_argument;
+            _p = p + len;
+            return std::errc {};
+        }
+    };
+
+    /// @note: a char is the next character as it is, whitespace included (like scanf's %c).
+    template<>
+    struct __scan_reader<char> {
+        static constexpr const char *check(__fmt_spec const &_s) {
+            return (_s._type == 0 || _s._type == 'c') && _s._prec < 0 ? nullptr : "invalid spec for a char";
+        }
+        static std::errc read(const char *&_p, const char *_end, char &_v, __fmt_spec const &, char) {
+            if (_p == _end)
+                return std::errc::invalid_argument;
+            _v = *_p++;
+            return std::errc {};
+        }
+    };
+
+    /// @note: strings are taken (after leading whitespace) up to the text that follows the field in the
+    ///     pattern: `{}` before a space stops at whitespace, `{}=` stops at the next '=', a field that ends
+    ///     the pattern takes the rest of the input; a precision caps the length (`{:.8}`). a string_view
+    ///     points into the input (no copy), a string is assigned a copy. empty strings do not match.
+    template<>
+    struct __scan_reader<std::string_view> {
+        static constexpr const char *check(__fmt_spec const &_s) {
+            return _s._type == 0 || _s._type == 's' ? nullptr : "invalid presentation type for a string";
+        }
+        static std::errc read(const char *&_p, const char *_end, std::string_view &_v, __fmt_spec const &_s, char _stop) {
+            const char *p = __scan_skip(_p, _end), *end = _end;
+            if (_s._prec >= 0 && (std::size_t) _s._prec < (std::size_t) (end - p))
+                end = p + _s._prec;
+            const char *stop = end;
+            if (_stop == ' ') {
+                for (stop = p; stop != end && !__scan_space(*stop); ++stop);
+            } else if (_stop != 0) {
+                if (const void *hit = std::memchr(p, _stop, (std::size_t) (end - p)))
+                    stop = (const char *) hit;
+            }
+            if (stop == p)
+                return std::errc::invalid_argument;
+            _v = std::string_view(p, (std::size_t) (stop - p));
+            _p = stop;
+            return std::errc {};
+        }
+    };
+
+    template<>
+    struct __scan_reader<std::string> {
+        static constexpr const char *check(__fmt_spec const &_s) {
+            return __scan_reader<std::string_view>::check(_s);
+        }
+        static std::errc read(const char *&_p, const char *_end, std::string &_v, __fmt_spec const &_s, char _stop) {
+            std::string_view sv;
+            std::errc ec = __scan_reader<std::string_view>::read(_p, _end, sv, _s, _stop);
+            if (ec == std::errc {})
+                _v.assign(sv.data(), sv.size());
+            return ec;
+        }
+    };
+
+    /// @note: scan pattern checked and split up at compile time against the argument types, with the
+    ///     format string grammar (`{}`, `{:x}`, `{:.8}`, doubled braces); a space in the literal text matches
+    ///     any run of whitespace (none included).
+    template<typename... pargs_t>
+    struct __scan_basic_string {
+        /// @field: the pattern itself.
+        std::string_view _str;
+
+        /// @field: literal runs (one more than there are arguments) and the spec of every field.
+        std::array<__fmt_literal, sizeof...(pargs_t) + 1> _lits {};
+        std::array<__fmt_spec, sizeof...(pargs_t)> _specs {};
+
+        /// @field: literal runs that can be compared as they are (no whitespace and no doubled braces).
+        std::array<bool, sizeof...(pargs_t) + 1> _plain {};
+
+        /// @field: the character that ends every (string) field.
+        std::array<char, sizeof...(pargs_t)> _stops {};
+
+        template<typename _s> requires std::convertible_to<_s const &, std::string_view>
+        consteval __scan_basic_string(_s const &_pattern) : _str(_pattern) {
+            if (const char *err = __fmt_parse(_str, _lits.data(), _specs.data(), sizeof...(pargs_t)))
+                __fmt_compile_error(err);
+            const char *err = nullptr;
+            std::size_t i = 0;
+            for (__fmt_spec const &spec : _specs)
+                if (spec._width != 0 || spec._align != 0 || spec._zero)
+                    err = "width and alignment are not allowed in a scan pattern";
+            ((err = err ? err : __scan_reader<pargs_t>::check(_specs[i]), ++i), ...);
+            if (err)
+                __fmt_compile_error(err);
+
+            for (i = 0; i < _lits.size(); ++i) {
+                _plain[i] = _lits[i]._esc == 0;
+                for (std::size_t k = 0; k < _lits[i]._len; ++k)
+                    if (__scan_space(_str[_lits[i]._off + k]))
+                        _plain[i] = false;
+            }
+            for (i = 0; i < _stops.size(); ++i) {
+                __fmt_literal const &next = _lits[i + 1];
+                if (next._len == 0)
+                    _stops[i] = i + 1 == _stops.size() ? '\0' : ' ';
+                else
+                    _stops[i] = __scan_space(_str[next._off]) ? ' ' : _str[next._off];
+            }
+        }
+    };
+
+    template<typename... pargs_t>
+    using __scan_string = __scan_basic_string<std::remove_cv_t<pargs_t>...>;
+
+    /// @fn: matches the _i'th literal run at _p: plain runs with one compare, the others a character at a
+    ///     time (whitespace runs against any whitespace, doubled braces against one brace).
+    template<typename _prog>
+    inline bool __scan_literal(const char *&_p, const char *_end, _prog const &_f, std::size_t _i) _GLIBCXX_NOEXCEPT {
+        __fmt_literal const &lit = _f._lits[_i];
+        const char *s = _f._str.data() + lit._off, *send = s + lit._len;
+        if (_f._plain[_i]) {
+            if ((std::size_t) (_end - _p) < lit._len || std::memcmp(_p, s, lit._len) != 0)
+                return false;
+            _p += lit._len;
+            return true;
+        }
+        while (s != send) {
+            if (__scan_space(*s)) {
+                while (s != send && __scan_space(*s))
+                    ++s;
+                _p = __scan_skip(_p, _end);
+                continue;
+            }
+            if (*s == '{' || *s == '}')
+                ++s;
+            if (_p == _end || *_p != *s)
+                return false;
+            ++_p, ++s;
+        }
+        return true;
+    }
+
+    /// @fn: parses text against a pattern (checked at compile time), storing every field into its argument.
+    ///     numbers go through std::from_chars and strings can be taken as string_views into the input, so
+    ///     nothing is allocated (unless an argument is a std::string).
+    ///     e.g. `std::scan(line, "{}={} ({:x})", key, value, flags)`.
+    /// @tparam: ...pargs_t the types of the arguments.
+    /// @param: _input the text to parse (it may go on after the match).
+    /// @param: _pattern the pattern, literal text and `{}` fields.
+    /// @param: _args the arguments to store into, in order.
+    /// @return: the number of arguments stored, the rest of the input and an error code.
+    template<typename... pargs_t>
+    _GLIBCXX_NODISCARD
+    inline scan_result
+    scan(std::string_view _input, __scan_string<pargs_t...> _pattern, pargs_t &... _args) {
+        const char *p = _input.data(), *end = p + _input.size();
+        scan_result result;
+        auto field = [&]<typename _ty>(std::size_t _i, _ty &_arg) {
+            if (!__scan_literal(p, end, _pattern, _i))
+                return result.ec = std::errc::invalid_argument, false;
+            result.ec = __scan_reader<std::remove_cv_t<_ty>>::read(p, end, _arg, _pattern._specs[_i], _pattern._stops[_i]);
+            return result.ec == std::errc {} && ++result.count;
+        };
+        bool matched = [&]<std::size_t... _is>(std::index_sequence<_is...>) {
+            return (field(_is, _args) && ...);
+        }(std::index_sequence_for<pargs_t...> {});
+        if (matched && !__scan_literal(p, end, _pattern, sizeof...(pargs_t)))
+            result.ec = std::errc::invalid_argument;
+        result.rest = std::string_view(p, (std::size_t) (end - p));
+        return result;
+    }
+}
+#endif
+#endif
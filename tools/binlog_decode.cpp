@@ -0,0 +1,57 @@
+/*
+ *		@brief: Decoder for the binary logs written by std::binlog (print.h), turns them back into text.
+ *
+ *		This file is part of CXX (https://github.com/seanhobeck/cxx).
+ *		Copyright (c) 2024 Sean Hobeck.
+ *
+ *		This program is free software: you can redistribute it and/or modify
+ *		it under the terms of the GNU General Public License as published by
+ *		the Free Software Foundation, either version 3 of the License, or
+ *		(at your option) any later version.
+ *
+ *		This program is distributed in the hope that it will be useful, but
+ *		WITHOUT ANY WARRANTY; without even the implied warranty of
+ *		MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ *		General Public License for more details.
+ *
+ *		You should have received a copy of the GNU General Public License
+ *		along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ *		@build:  g++ -std=c++20 -O2 tools/binlog_decode.cpp -o binlog_decode
+ *		@usage:  ./binlog_decode [log file = stdin]
+ *
+ *		the log has to be decoded on a machine with the byte order and type sizes of the one that wrote it.
+ *
+ */
+
+/// @uses: std::fopen, std::fread, std::fwrite, std::fprintf
+#include <cstdio>
+
+/// @uses: std::invalid_argument
+#include <stdexcept>
+
+#include "../print.h"
+
+int main(int argc, char **argv) {
+	FILE *fp = argc > 1 ? std::fopen(argv[1], "rb") : stdin;
+	if (!fp) {
+		std::fprintf(stderr, "binlog_decode: cannot open %s\n", argv[1]);
+		return 1;
+	}
+
+	std::string bytes;
+	char chunk[1 << 16];
+	for (std::size_t n; (n = std::fread(chunk, 1, sizeof(chunk), fp)) != 0;)
+		bytes.append(chunk, n);
+	if (fp != stdin)
+		std::fclose(fp);
+
+	try {
+		std::string text = std::binlog_decode(bytes);
+		std::fwrite(text.data(), 1, text.size(), stdout);
+	} catch (std::invalid_argument const &e) {
+		std::fprintf(stderr, "binlog_decode: %s\n", e.what());
+		return 1;
+	}
+	return 0;
+}
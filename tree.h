@@ -44,6 +44,30 @@
 /// @uses: std::shared_ptr<?>
 #include <memory>
 
+/// @uses: std::is_invocable_v<?>
+#include <type_traits>
+
+/// @uses: std::max, std::sort, std::find
+#include <algorithm>
+
+/// @uses: std::atomic<?>
+#include <atomic>
+
+/// @uses: std::thread
+#include <thread>
+
+/// @uses: std::unordered_map<?>
+#include <unordered_map>
+
+/// @uses: std::pair<?>, std::as_const
+#include <utility>
+
+/// @uses: std::uint64_t
+#include <cstdint>
+
+/// @uses: std::out_of_range
+#include <stdexcept>
+
 namespace std
 _GLIBCXX_VISIBILITY(default) {
 	/// @note: concept to make sure that the type provided is comparable in a struct.
@@ -55,12 +79,26 @@ _GLIBCXX_VISIBILITY(default) {
 		{ a != b } -> std::convertible_to<bool>;
 	};
 
+	/// @note: default number of pending nodes the traversal kernels prefetch ahead of the visit.
+	inline constexpr std::size_t __tree_prefetch_distance = 8;
+
+	/// @note: how children are matched against each other when comparing two trees.
+	enum class tree_policy : unsigned char {
+		/// children must appear in the same order.
+		ordered,
+		/// children may appear in any order (sibling lists are compared as multisets).
+		unordered,
+	};
+
 	/// @note: class for tree-like containers.
 	template<typename _ty> requires __is_cmp<_ty>
 	class tree {
 	public:
 		/// @note: internal class for nodes.
 		class node {
+			/// @note: the tree walks node storage directly (no copies) in its traversal kernels.
+			friend class tree;
+
 		protected:
 			/// @note: sort fns.
 			using _s_ifn = std::function<bool(_ty const&, _ty const&)>;
@@ -76,6 +114,14 @@ _GLIBCXX_VISIBILITY(default) {
 			/// @field: vector container of all children nodes.
 			std::vector<node> _children {};
 
+			/// @fn: points the parent of every child back at this node; the back references are
+			///	non-owning, so they have to follow the node whenever it is copied or moved (pushed
+			///	into a parent, a sibling list reallocating, sorting, returning a tree by value).
+			void _adopt() _GLIBCXX_NOEXCEPT {
+				for (auto &child : this->_children)
+					child._parent = std::shared_ptr<node>(std::shared_ptr<node>(), this);
+			}
+
 		public:
 			/// @note: constructor for a tree node.
 			_GLIBCXX20_CONSTEXPR node() : _parent(nullptr) {};
@@ -86,9 +132,59 @@ _GLIBCXX_VISIBILITY(default) {
 				: _data(data), _parent(parent) {
 			}
 
-			/// @fn: getter for the nodes children.
+			/// @note: copies and moves keep the children's parent references pointing at the new node.
+			///	copying and destroying walk the subtree with an explicit stack, so a chain of any depth
+			///	does not recurse once per level.
+			node(node const &o) : _data(o._data), _parent(o._parent) {
+				std::vector<std::pair<node *, node const *>> stack { { this, &o } };
+				while (!stack.empty()) {
+					auto [to, from] = stack.back();
+					stack.pop_back();
+					to->_children.reserve(from->_children.size());
+					for (auto const &child : from->_children)
+						to->_children.emplace_back(child._data, std::shared_ptr<node>(std::shared_ptr<node>(), to));
+					for (std::size_t i = 0; i < from->_children.size(); ++i)
+						stack.push_back({ &to->_children[i], &from->_children[i] });
+				}
+			}
+			node(node &&o) noexcept(std::is_nothrow_move_constructible_v<_ty>)
+				: _data(std::move(o._data)), _parent(std::move(o._parent)), _children(std::move(o._children)) {
+				this->_adopt();
+			}
+			node &operator=(node const &o) {
+				if (this != &o)
+					*this = node(o);
+				return *this;
+			}
+			node &operator=(node &&o) noexcept(std::is_nothrow_move_assignable_v<_ty>) {
+				this->_data = std::move(o._data);
+				this->_parent = std::move(o._parent);
+				this->_children = std::move(o._children);
+				this->_adopt();
+				return *this;
+			}
+			~node() {
+				/// tear the subtree down one leaf at a time without allocating a work stack: walk down along
+				///	the last children (re-pointing each parent reference on the way, so the walk back up
+				///	does not depend on them being current) and pop every node once it has become a leaf.
+				node *current = this;
+				for (;;) {
+					if (!current->_children.empty()) {
+						node *last = &current->_children.back();
+						last->_parent = std::shared_ptr<node>(std::shared_ptr<node>(), current);
+						current = last;
+						continue;
+					}
+					if (current == this)
+						break;
+					current = current->_parent.get();
+					current->_children.pop_back();
+				}
+			}
+
+			/// @fn: getter for the nodes children (by reference, walking a tree does not copy subtrees).
 			_GLIBCXX_NODISCARD
-			std::vector<node> children() _GLIBCXX_CONST { return this->_children; }
+			std::vector<node> const &children() const _GLIBCXX_CONST { return this->_children; }
 
 			/// @fn: getter for the nodes parent.
 			_GLIBCXX_NODISCARD
@@ -96,40 +192,47 @@ _GLIBCXX_VISIBILITY(default) {
 
 			/// @fn: getter for the nodes data.
 			_GLIBCXX_NODISCARD
-			_ty data() _GLIBCXX_CONST { return this->_data; }
+			_ty const &data() const _GLIBCXX_CONST { return this->_data; }
 
 			/// @fn: sorting items based on comparing items
 			template<typename _s_ifn = std::function<bool(_ty const&, _ty const&)>>
 			void isort(_s_ifn &fn) _GLIBCXX_NOEXCEPT {
-				/// sort all of the children...
-				std::sort(this->_children.begin(), this->_children.end(), fn);
-
-				/// if we are a leaf, dont do anymore sorting.
-				if (this->is_leaf())
-					return;
-				/// recursive for all of the child nodes...
-				for (auto& node : this->_children)
-					node.sort(fn);
+				/// sort every sibling list, walking the subtree with an explicit stack.
+				std::vector<node *> stack { this };
+				while (!stack.empty()) {
+					node *current = stack.back();
+					stack.pop_back();
+					std::sort(current->_children.begin(), current->_children.end(),
+						[&fn](node const &a, node const &b) { return fn(a._data, b._data); });
+					for (auto &child : current->_children)
+						stack.push_back(&child);
+				}
 			}
 
 			/// @fn: sorting nodes based on comparing item
 			template<typename _s_nfn = std::function<bool(node const&, node const&)>>
 			void nsort(_s_nfn &fn) _GLIBCXX_NOEXCEPT {
-				/// sort all of the children...
-				std::sort(this->_children.begin(), this->_children.end(), fn);
-
-				/// if we are a leaf, dont do anymore sorting.
-				if (this->is_leaf())
-					return;
-				/// recursive for all of the child nodes...
-				for (auto& node : this->_children)
-					node.sort(fn);
+				/// sort every sibling list, walking the subtree with an explicit stack.
+				std::vector<node *> stack { this };
+				while (!stack.empty()) {
+					node *current = stack.back();
+					stack.pop_back();
+					std::sort(current->_children.begin(), current->_children.end(), fn);
+					for (auto &child : current->_children)
+						stack.push_back(&child);
+				}
 			}
 
 			/// @fn: adds a child to this node.
 			void append(node const &child) {
-				child.parent = std::make_shared<node>(this);
-				this->_children.push_back(child);
+				this->append(node(child));
+			}
+
+			/// @fn: adds a child to this node (moving the subtree in, without copying it).
+			void append(node &&child) {
+				/// non-owning back reference, the parent owns the child and not the other way around.
+				child._parent = std::shared_ptr<node>(std::shared_ptr<node>(), this);
+				this->_children.push_back(std::move(child));
 			}
 
 			/// @fn: removes a child from this node.
@@ -170,7 +273,7 @@ _GLIBCXX_VISIBILITY(default) {
 			_GLIBCXX_NODISCARD
 			std::shared_ptr<node> operator[](unsigned int idx) _GLIBCXX_CONST {
 				if (idx >= this->_children.size())
-					__glibcxx_assert_fail(__FILE__, __LINE__, "tree<?>::node<?>::operator[]", "index out of range");
+					throw std::out_of_range("tree<?>::node<?>::operator[]: index out of range");
 
 				return std::make_shared<node>(this->_children[idx]);
 			};
@@ -188,45 +291,45 @@ _GLIBCXX_VISIBILITY(default) {
 			using _ref = _ty &;
 
 		private:
-			/// @field: stack of the current iterated nodes.
-			std::stack<node> _nodes;
+			/// @field: stack of the current iterated nodes (pointers into the tree, never copies of subtrees).
+			std::stack<node *> _nodes;
 
 		public:
 			/// @note: construction for the tree containers iterator.
-			_GLIBCXX20_CONSTEXPR explicit _iterator(node node) _GLIBCXX_NOEXCEPT {
+			_GLIBCXX20_CONSTEXPR explicit _iterator(node *node) _GLIBCXX_NOEXCEPT {
 				if (node) this->_nodes.push(node);
 			}
 
 			/// @fn: returns the stack of nodes used in the current iter.
 			_GLIBCXX_NODISCARD
-			std::stack<node> nodes() { return this->_nodes; };
+			std::stack<node *> const &nodes() const { return this->_nodes; };
 
 			/// @fn: overload operators for comparison on looping (eq)
 			_GLIBCXX_NODISCARD
-			bool operator==(_iterator const &other) _GLIBCXX_CONST {
-				return this->_nodes == other.nodes;
+			bool operator==(_iterator const &other) const {
+				return this->_nodes == other._nodes;
 			}
 
 			/// @fn: overload operators for comparison on looping (ne)
 			_GLIBCXX_NODISCARD
-			bool operator!=(_iterator const &other) _GLIBCXX_CONST {
+			bool operator!=(_iterator const &other) const {
 				return !(*this == other);
 			}
 
 			/// @fn: overload operator for references on de-reference of the iter.
 			_GLIBCXX_NODISCARD
-			_ref operator*() _GLIBCXX_CONST { return this->_nodes.top()->data; }
+			_ref operator*() const { return this->_nodes.top()->_data; }
 
 			/// @fn: overload operator for pointer grabbing the iter.
 			_GLIBCXX_NODISCARD
-			_ptr operator->() _GLIBCXX_CONST { return &this->_nodes.top()->data; }
+			_ptr operator->() const { return &this->_nodes.top()->_data; }
 
 			/// @fn: overload operator for iteration.
 			_iterator &operator++() {
 				auto current = this->_nodes.top();
 				this->_nodes.pop();
-				for (auto it = current->children().rbegin(); it != current->children().rend(); ++it)
-					this->_nodes.push(*it);
+				for (auto it = current->_children.rbegin(); it != current->_children.rend(); ++it)
+					this->_nodes.push(&*it);
 				return *this;
 			}
 
@@ -242,35 +345,425 @@ _GLIBCXX_VISIBILITY(default) {
 		/// @field: root node shared ptr.
 		node _root;
 
+		/// @fn: pre-order traversal kernel shared by the const and non-const overloads of traverse().
+		///	the pending stack holds the upcoming nodes in dfs order, so the children array of the node
+		///	_dist entries below the top is prefetched long before the walk descends into it; siblings
+		///	share one children array, so a single prefetch covers the whole sibling run.
+		template<typename _n, typename _v_fn>
+		static void __traverse(_n &root, _v_fn &fn, std::size_t _dist) {
+			struct _entry {
+				_n *node;
+				std::size_t depth;
+			};
+			std::vector<_entry> stack;
+			stack.reserve(64);
+			stack.push_back({ &root, 0 });
+			while (!stack.empty()) {
+				_entry current = stack.back();
+				stack.pop_back();
+
+				/// prefetch the children of an upcoming node (read-only, keep in all cache levels).
+				if (_dist != 0 && stack.size() >= _dist) {
+					_n *ahead = stack[stack.size() - _dist].node;
+					__builtin_prefetch(ahead->_children.data(), 0, 3);
+				}
+
+				if constexpr (std::is_invocable_v<_v_fn &, decltype((current.node->_data)), std::size_t>)
+					fn(current.node->_data, current.depth);
+				else
+					fn(current.node->_data);
+
+				/// push children in reverse so that the first child is visited next, and touch the
+				///	head of the children array now since it is needed on the very next iteration.
+				auto &children = current.node->_children;
+				if (children.empty())
+					continue;
+				__builtin_prefetch(children.data(), 0, 3);
+				for (auto it = children.rbegin(); it != children.rend(); ++it)
+					stack.push_back({ &*it, current.depth + 1 });
+			}
+		}
+
+		/// @note: a subtree laid out in pre-order with the hash of every node's subtree; the children of the
+		///	node at i start at i + 1 and each one follows the previous after _size entries.
+		struct __shape {
+			std::vector<node const *> _nodes;
+			std::vector<std::uint64_t> _hash;
+			std::vector<std::size_t> _size;
+		};
+
+		/// @fn: 64-bit finalizer (splitmix64).
+		static std::uint64_t __mix(std::uint64_t x) _GLIBCXX_NOEXCEPT {
+			x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+			x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+			return x ^ (x >> 31);
+		}
+
+		/// @fn: hash of a node's data, or 0 for types without std::hash (the shape alone is hashed then).
+		static std::uint64_t __data_hash(_ty const &v) {
+			if constexpr (requires { { std::hash<_ty> {}(v) } -> std::convertible_to<std::size_t>; })
+				return std::hash<_ty> {}(v);
+			else
+				return 0;
+		}
+
+		/// @fn: hashes every subtree bottom-up in one pass; the child hashes are combined with a sum, which
+		///	is order independent, so subtrees that are equal as unordered trees hash the same.
+		static __shape __hash_shape(node const &root) {
+			__shape s;
+			std::vector<node const *> stack { &root };
+			while (!stack.empty()) {
+				node const *x = stack.back();
+				stack.pop_back();
+				s._nodes.push_back(x);
+				for (auto it = x->_children.rbegin(); it != x->_children.rend(); ++it)
+					stack.push_back(&*it);
+			}
+			s._hash.resize(s._nodes.size());
+			s._size.resize(s._nodes.size());
+			for (std::size_t i = s._nodes.size(); i-- > 0;) {
+				node const *x = s._nodes[i];
+				std::uint64_t sum = 0;
+				std::size_t size = 1;
+				for (std::size_t k = 0, j = i + 1; k < x->_children.size(); ++k, j += s._size[j]) {
+					sum += __mix(s._hash[j] + 0x9e3779b97f4a7c15ull);
+					size += s._size[j];
+				}
+				s._size[i] = size;
+				s._hash[i] = __mix(__data_hash(x->_data) ^ __mix(sum + x->_children.size()));
+			}
+			return s;
+		}
+
+		/// @note: a child as (subtree hash, position in the shape).
+		using __keyed = std::pair<std::uint64_t, std::size_t>;
+
+		/// @fn: the children of the node at _i, sorted by subtree hash.
+		static void __sorted_children(__shape const &_s, std::size_t _i, std::vector<__keyed> &_out) {
+			_out.clear();
+			for (std::size_t k = 0, j = _i + 1; k < _s._nodes[_i]->_children.size(); ++k, j += _s._size[j])
+				_out.push_back({ _s._hash[j], j });
+			std::sort(_out.begin(), _out.end());
+		}
+
+		/// @fn: matches a run of _n children with equal hashes on both sides. equal hashes almost always
+		///	mean equal subtrees, so every child is tried against its counterpart first and the others are
+		///	only searched after a hash collision.
+		static bool __match_group(__shape const &sa, __keyed const *xs, __shape const &sb, __keyed const *ys,
+			std::size_t _n, std::atomic<bool> const &_stop) {
+			if (_n == 1)
+				return __match(sa, xs[0].second, sb, ys[0].second, _stop);
+			std::vector<bool> used(_n, false);
+			for (std::size_t i = 0; i < _n; ++i) {
+				bool found = false;
+				for (std::size_t t = 0; t < _n && !found; ++t) {
+					std::size_t j = (i + t) % _n;
+					if (!used[j] && __match(sa, xs[i].second, sb, ys[j].second, _stop))
+						used[j] = found = true;
+				}
+				if (!found)
+					return false;
+			}
+			return true;
+		}
+
+		/// @fn: exact unordered comparison of two hashed subtrees: sibling lists are sorted by hash (O(k log k))
+		///	and paired up, a differing hash sequence decides right away; gives up as soon as _stop is raised.
+		static bool __match(__shape const &sa, std::size_t _ia, __shape const &sb, std::size_t _ib, std::atomic<bool> const &_stop) {
+			auto same = [&](std::size_t i, std::size_t j) {
+				node const *x = sa._nodes[i], *y = sb._nodes[j];
+				return sa._hash[i] == sb._hash[j] && x->_data == y->_data && x->_children.size() == y->_children.size();
+			};
+			/// leaves are settled without touching the heap.
+			if (!same(_ia, _ib))
+				return false;
+			if (sa._nodes[_ia]->_children.empty())
+				return true;
+
+			std::vector<std::pair<std::size_t, std::size_t>> stack { { _ia, _ib } };
+			std::vector<__keyed> xs, ys;
+			for (std::size_t visited = 0; !stack.empty(); ++visited) {
+				auto [i, j] = stack.back();
+				stack.pop_back();
+				if (!same(i, j))
+					return false;
+				/// another worker found a difference, the answer is already known.
+				if ((visited & 1023) == 0 && _stop.load(std::memory_order_relaxed))
+					return false;
+				if (sa._nodes[i]->_children.empty())
+					continue;
+
+				__sorted_children(sa, i, xs);
+				__sorted_children(sb, j, ys);
+				for (std::size_t k = 0; k < xs.size(); ++k)
+					if (xs[k].first != ys[k].first)
+						return false;
+				for (std::size_t g = 0, e; g < xs.size(); g = e) {
+					for (e = g + 1; e < xs.size() && xs[e].first == xs[g].first; ++e);
+					if (e - g == 1)
+						stack.push_back({ xs[g].second, ys[g].second });
+					else if (!__match_group(sa, xs.data() + g, sb, ys.data() + g, e - g, _stop))
+						return false;
+				}
+			}
+			return true;
+		}
+
+		/// @fn: checks if a subtree is worth splitting over workers: its breadth-first frontier reaches _limit
+		///	nodes (the same test the ordered comparison widens its frontier with).
+		static bool __spans(node const &root, std::size_t _limit) {
+			std::vector<node const *> frontier { &root }, next;
+			while (frontier.size() < _limit) {
+				next.clear();
+				for (node const *x : frontier)
+					for (auto const &child : x->_children)
+						next.push_back(&child);
+				if (next.empty())
+					return false;
+				frontier.swap(next);
+			}
+			return true;
+		}
+
+		/// @fn: sequential structural comparison of two subtrees; gives up as soon as _stop is raised.
+		static bool __equal(node const &a, node const &b, tree_policy policy, std::atomic<bool> const &_stop) {
+			if (policy == tree_policy::unordered) {
+				if (a._data != b._data || a._children.size() != b._children.size())
+					return false;
+				__shape sa = __hash_shape(a), sb = __hash_shape(b);
+				return __match(sa, 0, sb, 0, _stop);
+			}
+
+			std::vector<std::pair<node const *, node const *>> stack { { &a, &b } };
+			for (std::size_t visited = 0; !stack.empty(); ++visited) {
+				auto [x, y] = stack.back();
+				stack.pop_back();
+				if (x->_data != y->_data || x->_children.size() != y->_children.size())
+					return false;
+				/// another worker found a difference, the answer is already known.
+				if ((visited & 1023) == 0 && _stop.load(std::memory_order_relaxed))
+					return false;
+				for (std::size_t i = 0; i < x->_children.size(); ++i)
+					stack.push_back({ &x->_children[i], &y->_children[i] });
+			}
+			return true;
+		}
+
+		/// @fn: runs _task(i) for every i in [0, _n) across _threads workers (the caller included),
+		///	handing out indices one by one so that uneven subtrees balance out.
+		template<typename _t_fn>
+		static void __parallel_for(std::size_t _n, unsigned _threads, _t_fn const &_task) {
+			std::atomic<std::size_t> next { 0 };
+			auto worker = [&]() {
+				for (std::size_t i; (i = next.fetch_add(1, std::memory_order_relaxed)) < _n;)
+					_task(i);
+			};
+			std::vector<std::thread> pool;
+			pool.reserve(_threads - 1);
+			for (unsigned t = 1; t < _threads; ++t)
+				pool.emplace_back(worker);
+			worker();
+			for (auto &thread : pool)
+				thread.join();
+		}
+
 	public:
 		/// @note: constructor for a tree container.
 		_GLIBCXX20_CONSTEXPR explicit tree(_ty data) {
 			this->_root = node(data);
 		};
-		_GLIBCXX20_CONSTEXPR explicit tree(node root) : _root(root) {
+		_GLIBCXX20_CONSTEXPR explicit tree(node root) : _root(std::move(root)) {
 		};
 
 		/// @fn: getting the beginning iterator.
 		_GLIBCXX_NODISCARD
-		_iterator begin() { return _iterator(_root); }
+		_iterator begin() { return _iterator(&this->_root); }
 
 		/// @fn: getting the ending iterator.
 		_GLIBCXX_NODISCARD
 		_iterator end() { return _iterator(nullptr); }
 
+		/// @fn: pre-order traversal that software-prefetches nodes ahead of the visit.
+		/// @param: fn visitor called with each node's data, or with (data, depth).
+		/// @param: distance number of pending nodes to prefetch ahead of the cursor (0 disables prefetching).
+		template<typename _v_fn>
+		void traverse(_v_fn &&fn, std::size_t distance = __tree_prefetch_distance) {
+			__traverse(this->_root, fn, distance);
+		}
+
+		/// @fn: pre-order traversal that software-prefetches nodes ahead of the visit (read-only).
+		template<typename _v_fn>
+		void traverse(_v_fn &&fn, std::size_t distance = __tree_prefetch_distance) const {
+			__traverse(this->_root, fn, distance);
+		}
+
+		/// @fn: full structural comparison against another tree (data of every node and the shape).
+		/// @param: other the tree to compare against.
+		/// @param: policy whether children have to appear in the same order or in any order.
+		/// @param: threads number of workers, 0 uses the hardware concurrency.
+		/// @note: disjoint subtrees are compared in parallel and every worker stops at the first difference.
+		_GLIBCXX_NODISCARD
+		bool equal(tree const &other, tree_policy policy = tree_policy::ordered, unsigned threads = 0) const {
+			if (threads == 0)
+				threads = std::max(1u, std::thread::hardware_concurrency());
+
+			/// walk down from the roots while there is a single child, then split the work over the first
+			///	sibling list (multiset matching only ever happens inside one sibling list).
+			node const *a = &this->_root, *b = &other._root;
+			while (a->_children.size() == 1 && b->_children.size() == 1) {
+				if (a->_data != b->_data)
+					return false;
+				a = &a->_children.front(), b = &b->_children.front();
+			}
+
+			std::atomic<bool> stop { false };
+			if (threads == 1)
+				return __equal(*a, *b, policy, stop);
+			if (a->_data != b->_data || a->_children.size() != b->_children.size())
+				return false;
+
+			if (policy == tree_policy::unordered) {
+				/// small trees are compared right here, like the ordered frontier decides them.
+				if (!__spans(*a, threads * 8ul))
+					return __equal(*a, *b, policy, stop);
+
+				/// hash both trees side by side, then pair the top sibling list by hash and hand the
+				///	runs of equal hashes out to the workers.
+				__shape sa, sb;
+				{
+					std::thread worker([&]() { sb = __hash_shape(*b); });
+					sa = __hash_shape(*a);
+					worker.join();
+				}
+				if (sa._hash[0] != sb._hash[0])
+					return false;
+				std::vector<__keyed> xs, ys;
+				__sorted_children(sa, 0, xs);
+				__sorted_children(sb, 0, ys);
+				for (std::size_t k = 0; k < xs.size(); ++k)
+					if (xs[k].first != ys[k].first)
+						return false;
+				std::vector<std::pair<std::size_t, std::size_t>> groups;
+				for (std::size_t g = 0, e; g < xs.size(); g = e) {
+					for (e = g + 1; e < xs.size() && xs[e].first == xs[g].first; ++e);
+					groups.push_back({ g, e - g });
+				}
+				__parallel_for(groups.size(), threads, [&](std::size_t i) {
+					auto [g, n] = groups[i];
+					if (!stop.load(std::memory_order_relaxed) && !__match_group(sa, xs.data() + g, sb, ys.data() + g, n, stop))
+						stop.store(true, std::memory_order_relaxed);
+				});
+				return !stop.load();
+			}
+
+			/// ordered: widen the frontier breadth-first until there are enough independent subtree pairs
+			///	to keep every worker busy (small trees are decided right here without spawning anything).
+			std::vector<std::pair<node const *, node const *>> frontier { { a, b } }, next;
+			while (frontier.size() < threads * 8ul) {
+				next.clear();
+				for (auto [x, y] : frontier) {
+					if (x->_data != y->_data || x->_children.size() != y->_children.size())
+						return false;
+					for (std::size_t i = 0; i < x->_children.size(); ++i)
+						next.push_back({ &x->_children[i], &y->_children[i] });
+				}
+				if (next.empty())
+					return true;
+				frontier.swap(next);
+			}
+			__parallel_for(frontier.size(), threads, [&](std::size_t i) {
+				if (!stop.load(std::memory_order_relaxed) && !__equal(*frontier[i].first, *frontier[i].second, policy, stop))
+					stop.store(true, std::memory_order_relaxed);
+			});
+			return !stop.load();
+		}
+
+		/// @fn: merges another tree into this one, unioning children by key at every level.
+		/// @param: other the tree to merge in, its nodes are moved out (it is left valid but unspecified).
+		/// @param: key maps a node's data to the key that siblings are matched on (must be hashable).
+		/// @param: on_conflict called as on_conflict(ours, theirs) for every pair of nodes sharing a key
+		///	(the roots always do), ours is updated in place and the children of both are merged next.
+		/// @note: subtrees only present in other are moved over whole, and subtrees only present in this
+		///	tree are never entered. nothing is kept between calls: at every level reached their sibling list
+		///	is hashed and ours is scanned (until all of their keys are matched), so the work is linear in the
+		///	overlap of the two trees and the sibling lists along it.
+		template<typename _k_fn, typename _c_fn>
+		void merge(tree &&other, _k_fn &&key, _c_fn &&on_conflict) {
+			using _key_ty = std::decay_t<std::invoke_result_t<_k_fn &, _ty const &>>;
+
+			on_conflict(this->_root._data, std::move(other._root._data));
+			std::vector<std::pair<node *, node *>> stack { { &this->_root, &other._root } };
+			/// their keys -> position of the matching child in our list (npos until one is found).
+			constexpr std::size_t npos = ~std::size_t(0);
+			std::unordered_map<_key_ty, std::size_t> index;
+			std::vector<typename std::unordered_map<_key_ty, std::size_t>::iterator> slots;
+			std::vector<std::pair<std::size_t, node *>> matched;
+			while (!stack.empty()) {
+				auto [ours, theirs] = stack.back();
+				stack.pop_back();
+				if (theirs->_children.empty())
+					continue;
+
+				/// nothing to match against, take their children over wholesale.
+				if (ours->_children.empty()) {
+					ours->_children = std::move(theirs->_children);
+					ours->_adopt();
+					continue;
+				}
+
+				/// only their list is hashed (reserved up front, so the slots stay valid); our list is only
+				///	looked up, and the scan stops once every one of their keys has found its match.
+				index.clear();
+				index.reserve(theirs->_children.size());
+				slots.clear();
+				for (auto const &child : theirs->_children)
+					slots.push_back(index.try_emplace(key(std::as_const(child._data)), npos).first);
+				std::size_t missing = index.size();
+				for (std::size_t i = 0; i < ours->_children.size() && missing != 0; ++i) {
+					auto it = index.find(key(std::as_const(ours->_children[i]._data)));
+					if (it != index.end() && it->second == npos)
+						it->second = i, --missing;
+				}
+
+				matched.clear();
+				for (std::size_t j = 0; j < theirs->_children.size(); ++j) {
+					node &child = theirs->_children[j];
+					auto it = slots[j];
+					if (it->second == npos) {
+						it->second = ours->_children.size();
+						ours->append(std::move(child));
+						continue;
+					}
+					on_conflict(ours->_children[it->second]._data, std::move(child._data));
+					matched.push_back({ it->second, &child });
+				}
+
+				/// pointers into ours->_children are only taken once it has stopped growing; stack order
+				///	then guarantees a subtree is finished before its parent's list can be touched again.
+				for (auto [i, child] : matched)
+					stack.push_back({ &ours->_children[i], child });
+			}
+		}
+
+		/// @fn: merges another tree into this one, keeping our data whenever two nodes share a key.
+		template<typename _k_fn>
+		void merge(tree &&other, _k_fn &&key) {
+			this->merge(std::move(other), std::forward<_k_fn>(key), [](_ty &, _ty &&) {});
+		}
+
 		/// @fn: function made to search the entire tree for a _ty (data template that matches the provided)
 		_GLIBCXX_NODISCARD
-		std::shared_ptr<node> search(_ty const &data) _GLIBCXX_CONST {
-			std::stack<node> node_stack;
-			node_stack.push(this->_root);
+		std::shared_ptr<node> search(_ty const &data) const {
+			/// walks the storage in place, only the node found is copied out.
+			std::vector<node const *> node_stack { &this->_root };
 			while (!node_stack.empty()) {
-				node current_node = node_stack.top();
-				node_stack.pop();
+				node const *current_node = node_stack.back();
+				node_stack.pop_back();
 
-				if (current_node.data() == data)
-					return std::make_shared<node>(current_node);
-				for (const node child: current_node.children())
-					node_stack.push(child);
+				if (current_node->data() == data)
+					return std::make_shared<node>(*current_node);
+				for (node const &child : current_node->children())
+					node_stack.push_back(&child);
 			}
 			return nullptr;
 		}
@@ -289,8 +782,12 @@ _GLIBCXX_VISIBILITY(default) {
 
 		/// @fn: adds a child to this tree's root node.
 		void append(node const &child) {
-			child.parent = std::make_shared<node>(this->_root);
-			this->_root.push_back(child);
+			this->_root.append(child);
+		}
+
+		/// @fn: adds a child to this tree's root node (moving the subtree in, without copying it).
+		void append(node &&child) {
+			this->_root.append(std::move(child));
 		}
 
 		/// @fn: removes a child from this tree's root node.
@@ -305,7 +802,7 @@ _GLIBCXX_VISIBILITY(default) {
 
 		/// @fn: grabbing the instance of the root node.
 		_GLIBCXX_NODISCARD
-		node const& root() _GLIBCXX_CONST {
+		node const& root() const _GLIBCXX_CONST {
 			return this->_root;
 		};
 